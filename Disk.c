@@ -0,0 +1,299 @@
+// Disk.c
+// Simulated files and the disk device with its request scheduling policies
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "Disk.h"
+#include "Storage.h"
+
+#define FILE_TABLE_INITIAL 16
+#define DISK_MAX_REQUESTS INT32_MAX
+#define FILE_SET_MAX 65536
+
+// ============================================================================
+// Files
+// ============================================================================
+
+static unsigned nameHash(const char* name) {
+    uintptr_t v = (uintptr_t)name;
+    v ^= v >> 17;
+    v *= 0xed5ad4bbu;
+    v ^= v >> 11;
+    return (unsigned)v;
+}
+
+void freeFileTable(FileTable* t) {
+    free(t->slots);
+    t->slots = NULL;
+    t->capacity = 0;
+    t->count = 0;
+}
+
+bool copyFileTable(FileTable* dst, const FileTable* src) {
+    *dst = *src;
+    if (copyArray((void**)&dst->slots, src->slots, src->capacity, sizeof(SimFile)))
+        return true;
+    dst->capacity = 0;
+    dst->count = 0;
+    return false;
+}
+
+SimFile* fileFind(const FileTable* t, const char* name) {
+    if (t->capacity == 0)
+        return NULL;
+    unsigned mask = t->capacity - 1;
+    for (unsigned i = nameHash(name) & mask; t->slots[i].name; i = (i + 1) & mask) {
+        if (t->slots[i].name == name)
+            return &t->slots[i];
+    }
+    return NULL;
+}
+
+// Rehash into a table twice the size
+static bool growFileTable(FileTable* t) {
+    int capacity = t->capacity > 0 ? t->capacity * 2 : FILE_TABLE_INITIAL;
+    SimFile* slots = calloc(capacity, sizeof(SimFile));
+    if (slots == NULL)
+        return false;
+    unsigned mask = capacity - 1;
+    for (int j = 0; j < t->capacity; j++) {
+        if (t->slots[j].name == NULL)
+            continue;
+        unsigned i = nameHash(t->slots[j].name) & mask;
+        while (slots[i].name)
+            i = (i + 1) & mask;
+        slots[i] = t->slots[j];
+    }
+    free(t->slots);
+    t->slots = slots;
+    t->capacity = capacity;
+    return true;
+}
+
+SimFile* fileAdd(FileTable* t, const char* name) {
+    // Keep the load factor at or below 1/2
+    if (2 * (t->count + 1) > t->capacity && !growFileTable(t))
+        return NULL;
+    unsigned mask = t->capacity - 1;
+    unsigned i = nameHash(name) & mask;
+    while (t->slots[i].name)
+        i = (i + 1) & mask;
+    t->slots[i].name = name;
+    t->slots[i].content = NULL;
+    t->slots[i].dirty = false;
+    t->slots[i].start = 0;
+    t->slots[i].blocks = 0;
+    t->count++;
+    return &t->slots[i];
+}
+
+// ============================================================================
+// Host files
+// ============================================================================
+
+void freeFileSet(FileSet* s) {
+    for (int i = 0; i < s->count; i++) {
+        free(s->files[i].name);
+        free(s->files[i].content);
+    }
+    free(s->files);
+    memset(s, 0, sizeof(FileSet));
+}
+
+// Loading a name again replaces its content
+bool fileSetLoad(FileSet* s, const char* name, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+        return false;
+    char* content = malloc(FILE_MAX_CONTENT);
+    if (content == NULL) {
+        fclose(file);
+        return false;
+    }
+    size_t total = fread(content, 1, FILE_MAX_CONTENT - 1, file);
+    content[total] = '\0';
+    bool ok = !ferror(file);
+    fclose(file);
+
+    int i = 0;
+    while (i < s->count && strcmp(s->files[i].name, name) != 0)
+        i++;
+    if (ok && i == s->count) {
+        ok = growArray((void**)&s->files, &s->capacity, s->count + 1, FILE_SET_MAX, sizeof(HostFile)) &&
+             (s->files[i].name = strdup(name)) != NULL;
+        if (ok) {
+            s->files[i].content = NULL;
+            s->count++;
+        }
+    }
+    if (!ok) {
+        free(content);
+        return false;
+    }
+    free(s->files[i].content);
+    s->files[i].content = content;
+    return true;
+}
+
+const char* fileSetFind(const FileSet* s, const char* name) {
+    for (int i = 0; i < s->count; i++) {
+        if (strcmp(s->files[i].name, name) == 0)
+            return s->files[i].content;
+    }
+    return NULL;
+}
+
+// ============================================================================
+// Device
+// ============================================================================
+
+void freeDisk(Disk* d) {
+    free(d->waiting);
+    free(d->active);
+    memset(d, 0, sizeof(Disk));
+}
+
+bool copyDisk(Disk* dst, const Disk* src) {
+    *dst = *src;
+    dst->waiting = NULL;
+    dst->active = NULL;
+    dst->waiting_capacity = src->waiting_count;
+    dst->active_capacity = src->active_count;
+    if (copyArray((void**)&dst->waiting, src->waiting, src->waiting_count, sizeof(DiskRequest)) &&
+        copyArray((void**)&dst->active, src->active, src->active_count, sizeof(DiskRequest)))
+        return true;
+    freeDisk(dst);
+    return false;
+}
+
+bool diskSubmit(Disk* d, const DiskRequest* request) {
+    if (!growArray((void**)&d->waiting, &d->waiting_capacity, d->waiting_count + 1,
+                   DISK_MAX_REQUESTS, sizeof(DiskRequest)))
+        return false;
+    d->waiting[d->waiting_count] = *request;
+    d->waiting[d->waiting_count].done = -1;
+    d->waiting_count++;
+    // A replayed request brings its blocks along; SCAN runs to the last one
+    if (d->block_count < request->start + request->blocks)
+        d->block_count = request->start + request->blocks;
+    return true;
+}
+
+int diskAllocate(Disk* d, int blocks) {
+    int start = d->block_count;
+    d->block_count += blocks;
+    return start;
+}
+
+int diskBlocksFor(int bytes) {
+    return bytes > 0 ? (bytes + DISK_BLOCK_SIZE - 1) / DISK_BLOCK_SIZE : 1;
+}
+
+// Waiting request closest to the head on the given side (at or above it when
+// `up`), oldest on ties; -1 if there is none
+static int nearestRequest(const Disk* d, bool up) {
+    int best = -1, best_distance = 0;
+    for (int i = 0; i < d->waiting_count; i++) {
+        int distance = d->waiting[i].start - d->head;
+        if (up ? distance < 0 : distance > 0)
+            continue;
+        if (distance < 0)
+            distance = -distance;
+        if (best < 0 || distance < best_distance) {
+            best = i;
+            best_distance = distance;
+        }
+    }
+    return best;
+}
+
+// Waiting request the policy serves next; moves the head for the travel a
+// sweep makes before turning around
+static int pickRequest(Disk* d, DiskPolicy policy) {
+    switch (policy) {
+        case DISK_SSTF: {
+            int best = -1, best_distance = 0;
+            for (int i = 0; i < d->waiting_count; i++) {
+                int distance = abs(d->waiting[i].start - d->head);
+                if (best < 0 || distance < best_distance) {
+                    best = i;
+                    best_distance = distance;
+                }
+            }
+            return best;
+        }
+        case DISK_SCAN: {
+            int next = nearestRequest(d, !d->moving_down);
+            if (next >= 0)
+                return next;
+            // Run on to the end of the disk, then sweep back
+            int edge = d->moving_down ? 0 : (d->block_count > 0 ? d->block_count - 1 : 0);
+            d->seek_distance += abs(edge - d->head);
+            d->head = edge;
+            d->moving_down = !d->moving_down;
+            return nearestRequest(d, !d->moving_down);
+        }
+        case DISK_CLOOK: {
+            int next = nearestRequest(d, true);
+            if (next >= 0)
+                return next;
+            // Jump back to the lowest request and sweep up from there
+            int lowest = 0;
+            for (int i = 1; i < d->waiting_count; i++) {
+                if (d->waiting[i].start < d->waiting[lowest].start)
+                    lowest = i;
+            }
+            return lowest;
+        }
+        default:
+            return 0;
+    }
+}
+
+void diskStart(Disk* d, int now, int latency, int depth, DiskPolicy policy) {
+    while (d->waiting_count > 0 && d->active_count < depth &&
+           growArray((void**)&d->active, &d->active_capacity, d->active_count + 1,
+                     DISK_MAX_REQUESTS, sizeof(DiskRequest))) {
+        int i = pickRequest(d, policy);
+        DiskRequest* r = &d->active[d->active_count++];
+        *r = d->waiting[i];
+        d->waiting_count--;
+        memmove(d->waiting + i, d->waiting + i + 1, (d->waiting_count - i) * sizeof(DiskRequest));
+
+        int seek = abs(r->start - d->head);
+        d->seek_distance += seek;
+        r->done = now + latency + (seek + DISK_SEEK_BLOCKS - 1) / DISK_SEEK_BLOCKS;
+        d->head = r->start + (r->blocks > 0 ? r->blocks - 1 : 0);
+    }
+}
+
+int diskNextCompletion(const Disk* d) {
+    int next = -1;
+    for (int i = 0; i < d->active_count; i++) {
+        if (next < 0 || d->active[i].done < next)
+            next = d->active[i].done;
+    }
+    return next;
+}
+
+bool diskPopCompleted(Disk* d, int now, DiskRequest* out) {
+    int best = -1;
+    for (int i = 0; i < d->active_count; i++) {
+        if (d->active[i].done <= now && (best < 0 || d->active[i].done < d->active[best].done))
+            best = i;
+    }
+    if (best < 0)
+        return false;
+    *out = d->active[best];
+    d->active_count--;
+    memmove(d->active + best, d->active + best + 1, (d->active_count - best) * sizeof(DiskRequest));
+    d->completed++;
+    histogramAdd(&d->latency, now - out->submitted);
+    return true;
+}
+
+const char* diskPolicyName(DiskPolicy policy) {
+    static const char* names[DISK_POLICY_COUNT] = { "FCFS", "SSTF", "SCAN", "C-LOOK" };
+    return policy >= 0 && policy < DISK_POLICY_COUNT ? names[policy] : "Unknown";
+}
@@ -0,0 +1,119 @@
+// Disk.h - Simulated files and the disk device that file instructions go
+// through. Files live in memory: host files are loaded ahead of the run and
+// changes reach the host file system only when the front end syncs them.
+// Each file occupies a range of blocks on the device, whose head seeks from
+// request to request in the order a disk scheduling policy picks; a request
+// takes a fixed latency plus the seek time.
+#ifndef DISK_H
+#define DISK_H
+
+#include <stdbool.h>
+#include "Metrics.h"
+
+#define DISK_DEFAULT_DEPTH 1
+#define FILE_MAX_CONTENT 10000    // bytes of a host file that are loaded, with the '\0'
+#define DISK_BLOCK_SIZE 512       // bytes per block
+#define DISK_SEEK_BLOCKS 16       // blocks the head crosses per cycle
+
+// Order in which waiting requests get the head
+typedef enum {
+    DISK_FCFS,   // oldest first
+    DISK_SSTF,   // shortest seek from the head first
+    DISK_SCAN,   // elevator: sweep to one end of the disk, then back
+    DISK_CLOOK,  // sweep upwards only, then jump to the lowest request
+    DISK_POLICY_COUNT
+} DiskPolicy;
+
+// -----------------------------------------------------------------------------
+// Files: open addressing hash set keyed by name. Names are interned arena
+// strings, so two entries are the same file exactly when the pointers match.
+// A zeroed FileTable is empty.
+// -----------------------------------------------------------------------------
+typedef struct {
+    const char* name;   // NULL for an empty slot
+    const char* content; // arena string; NULL if the file does not exist
+    bool dirty;         // written since the last sync to the host
+    int start;          // first block on the disk
+    int blocks;         // 0 until the file is first placed on the disk
+} SimFile;
+
+typedef struct {
+    SimFile* slots;
+    int capacity;       // power of two
+    int count;
+} FileTable;
+
+void freeFileTable(FileTable* t);
+bool copyFileTable(FileTable* dst, const FileTable* src);
+SimFile* fileFind(const FileTable* t, const char* name); // NULL if never seen
+SimFile* fileAdd(FileTable* t, const char* name);        // new entry with no content;
+                                                         // NULL when out of memory
+
+// -----------------------------------------------------------------------------
+// Host files loaded ahead of a run, so the run itself never waits on the host
+// file system. A set is only read while runs use it, so runs on several
+// threads can share one. A zeroed FileSet is empty.
+// -----------------------------------------------------------------------------
+typedef struct {
+    char* name;         // as programs refer to it
+    char* content;
+} HostFile;
+
+typedef struct {
+    HostFile* files;
+    int count;
+    int capacity;
+} FileSet;
+
+void freeFileSet(FileSet* s);
+bool fileSetLoad(FileSet* s, const char* name, const char* path); // false if unreadable
+const char* fileSetFind(const FileSet* s, const char* name);      // NULL if not loaded
+
+// -----------------------------------------------------------------------------
+// Device: requests wait until one of `depth` service slots is free and the
+// policy picks them. A started request moves the head to its blocks and
+// completes `latency` cycles plus the seek time later; the head then rests on
+// its last block. Blocks are handed out to files in order and never reused.
+// A zeroed Disk is idle, with the head on block 0 moving up.
+// -----------------------------------------------------------------------------
+typedef struct {
+    int index;          // process waiting for the request
+    const char* name;   // interned file name; NULL when only the timing matters
+    const char* data;   // arena string to write, NULL for a read
+    int slot;           // variable slot a read goes to, -1 to only log it
+    int start;          // first block of the file
+    int blocks;         // blocks transferred
+    int submitted;      // clock cycle it was issued
+    int done;           // clock cycle it completes, -1 while waiting
+} DiskRequest;
+
+typedef struct {
+    DiskRequest* waiting;   // oldest first
+    int waiting_count;
+    int waiting_capacity;
+    DiskRequest* active;    // in service, in the order they started
+    int active_count;
+    int active_capacity;
+    int head;               // block under the head
+    bool moving_down;       // SCAN direction
+    int block_count;        // blocks handed out to files so far
+
+    // Statistics since the last reset
+    long long completed;
+    long long busy_cycles;    // cycles with a request in service
+    long long overlap_cycles; // busy cycles in which a core ran too
+    long long seek_distance;  // blocks the head moved
+    Histogram latency;        // cycles from submission to completion
+} Disk;
+
+void freeDisk(Disk* d);
+bool copyDisk(Disk* dst, const Disk* src);
+int  diskAllocate(Disk* d, int blocks);                  // first block of a new range
+int  diskBlocksFor(int bytes);                            // blocks a file of that size needs
+bool diskSubmit(Disk* d, const DiskRequest* request);
+void diskStart(Disk* d, int now, int latency, int depth, DiskPolicy policy); // fill free slots
+int  diskNextCompletion(const Disk* d);                  // -1 if nothing is in service
+bool diskPopCompleted(Disk* d, int now, DiskRequest* out); // earliest done first
+const char* diskPolicyName(DiskPolicy policy);
+
+#endif // DISK_H
@@ -0,0 +1,285 @@
+// Engine.h - C API of the headless simulation core (MS2.c + Queues.c)
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Queues.h"
+#include "Storage.h"
+#include "Trace.h"
+#include "Metrics.h"
+#include "Input.h"
+#include "Output.h"
+#include "Disk.h"
+
+// -----------------------------------------------------------------------------
+// Front end hooks. Any of them may be NULL; the engine never depends on a display.
+// -----------------------------------------------------------------------------
+typedef struct {
+    void (*log)(const char* message);                    // engine log line
+    bool (*read_input)(PCB* process, const char* variable,
+                       char* out, int out_size);          // value for "assign x input"
+    void (*show_output)(PCB* process, const char* text); // print / printFromTo
+    void (*on_update)(void);                             // engine state changed
+} EngineClient;
+
+// -----------------------------------------------------------------------------
+// Dirty tracking: what changed since the front end last called engineClearChanges()
+// -----------------------------------------------------------------------------
+#define CHANGED_QUEUES    0x1 // ready / MLFQ queue contents or order
+#define CHANGED_RESOURCES 0x2 // mutex holders and wait heaps
+#define CHANGED_ALL       0x4 // engine was (re)initialized, rebuild everything
+
+typedef struct {
+    unsigned flags;
+    int* processes;     // indices of processes whose row changed (no duplicates)
+    int  process_count;
+    int  process_capacity;
+    int* words;         // addresses of memory words that changed (no duplicates)
+    int  word_count;
+    int  word_capacity;
+} EngineChanges;
+
+// -----------------------------------------------------------------------------
+// Scheduling policies (Schedulers.c). The engine owns the dispatch loop and
+// calls into the policy for the current SchedulingAlgorithm; every hook gets
+// the simulated core it concerns and an index into processes[].
+// -----------------------------------------------------------------------------
+#define MAX_CPUS 16
+
+typedef struct {
+    const char* name;
+    void (*reset)(void);                            // drop policy state on every core; may be NULL
+    int  (*pick_next)(int cpu, int* slice);         // remove and return the next process in
+                                                    // cpu's run queue (-1 if none); *slice =
+                                                    // cycles it may run before preemption,
+                                                    // 0 = no limit
+    void (*on_arrival)(int cpu, int index);         // process became runnable for the first time
+    void (*on_block)(int cpu, int index);           // process left the core blocked on a mutex
+    void (*on_unblock)(int cpu, int index);         // blocked process was handed its mutex
+    void (*on_quantum_expire)(int cpu, int index);  // process used up its slice
+    void (*on_finish)(int cpu, int index);          // process ran its last instruction
+    void (*on_migrate)(int from, int to, int index); // picked from `from` to run on `to`;
+                                                    // may be NULL
+} SchedulerOps;
+
+extern const SchedulerOps fcfsScheduler;
+extern const SchedulerOps roundRobinScheduler;
+extern const SchedulerOps mlfqScheduler;
+extern const SchedulerOps cfsScheduler;
+
+// MLFQ shape; change the levels and quanta through mlfqConfigure()
+#define MLFQ_MAX_LEVELS 64
+#define MLFQ_DEFAULT_LEVELS 4
+#define MLFQ_MAX_QUANTUM 4096
+bool mlfqConfigure(int levels, const int* quanta);
+const SchedulerOps* schedulerFor(SchedulingAlgorithm algorithm);
+int cfsWeight(int priority);
+
+// -----------------------------------------------------------------------------
+// Simulated cores. Every core runs one instruction per clock cycle, in core
+// order; an idle core with an empty run queue steals from the longest queue.
+// -----------------------------------------------------------------------------
+typedef struct {
+    int running;      // index into processes[], -1 when idle
+    int slice;        // cycles granted by pick_next, 0 = no limit
+    int queued;       // processes waiting in this core's run queue
+    int busy_cycles;  // cycles spent executing instructions
+    int migrations;   // processes stolen from other cores
+} Core;
+
+// -----------------------------------------------------------------------------
+// Per-run metrics. Every process keeps its own counters in its PCB; the
+// engine also folds them into one histogram per metric as they become known
+// (response at the first dispatch, the rest when the process finishes).
+// -----------------------------------------------------------------------------
+typedef enum {
+    METRIC_TURNAROUND,  // completion - arrival
+    METRIC_RESPONSE,    // first dispatch - arrival
+    METRIC_WAITING,     // turnaround - instructions executed
+    METRIC_READY,       // cycles in a ready queue
+    METRIC_BLOCKED,     // cycles blocked on any mutex
+    METRIC_IO,          // cycles blocked on disk requests
+    METRIC_SWITCHES,    // dispatches onto a core
+    METRIC_COUNT
+} Metric;
+
+// Cores, algorithm, quantum, fast-forward, boost, levels, quanta per level,
+// then disk latency, queue depth and policy
+#define TRACE_CONFIG_INTS (9 + MLFQ_MAX_LEVELS)
+
+// Resource number of the disk in trace BLOCK / UNBLOCK events (after the mutexes)
+#define DISK_RESOURCE 3
+
+// -----------------------------------------------------------------------------
+// Snapshots for stepping backwards. A snapshot is a flat copy of the run state
+// of an instance (settings, process table, memory, queues, wait heaps, policy
+// state, files, disk requests, clock); strings stay shared with the arena,
+// which only grows until the next reset. Restoring one and re-running the
+// cycles after it quietly reaches any earlier cycle.
+// -----------------------------------------------------------------------------
+#define SNAPSHOT_DEFAULT_LIMIT 32
+
+struct Simulation;
+
+typedef struct {
+    struct Simulation* state; // owns copies of every table and queue
+    bool forced;              // taken because processes or settings changed;
+                              // never thinned out
+} Snapshot;
+
+// A value read for "assign x input", kept so re-run cycles see the same input
+typedef struct {
+    int clock;
+    int index;                // process that read it
+    char* value;              // arena string
+} InputRecord;
+
+// -----------------------------------------------------------------------------
+// Simulation instance: everything one run owns. Engine functions work on the
+// calling thread's current instance `sim`, so independent simulations can run
+// concurrently on different threads (see engineSelect).
+// -----------------------------------------------------------------------------
+typedef struct Simulation {
+    // Configuration
+    SchedulingAlgorithm current_algorithm;
+    int quantum;
+    int cpu_count;                         // change through engineSetCpuCount()
+    bool fast_forward_idle;
+    int mlfq_level_count;
+    int mlfq_quanta[MLFQ_MAX_LEVELS];      // 0 = default (1, 2, 4, ... per level)
+    int mlfq_boost_interval;               // cycles between priority boosts, 0 = off
+    int disk_latency;                      // cycles per file request, 0 = instant
+    int disk_queue_depth;                  // requests the disk serves at once
+    DiskPolicy disk_policy;                // order waiting requests get the head
+    EngineClient client;
+
+    // Processes and simulated memory
+    PCB* processes;                        // grows up to process_limit (Storage.h)
+    int process_count;
+    int process_capacity;
+    MemoryWord* memory;
+    int memory_size;
+    int memory_capacity;
+    Arena arena;                           // program text, decoded code, memory strings
+
+    // Run state
+    int clock_cycle;
+    int finished_count;
+    int idleCount;                         // cycles in which every core was idle
+    Resource resources[3];                 // userInput, userOutput, file
+    Core cores[MAX_CPUS];
+    ArrivalQueue pendingArrivals;          // loaded processes that have not arrived yet
+    const SchedulerOps* scheduler;         // policy the ready processes belong to
+    EngineChanges changes;                 // since the front end last refreshed
+    InputSource input;                     // values for "assign x input"
+    OutputSink output;                     // "print" and "printFromTo" output
+    FileSet host_files;                    // loaded with engineLoadFile()
+    const FileSet* shared_files;           // another instance's, used instead
+    Histogram metrics[METRIC_COUNT];       // over the processes seen so far
+    FileTable files;                       // simulated files (engineSyncFiles)
+    Disk disk;                             // file requests in flight
+
+    // Execution trace
+    TraceWriter* trace;                    // recording, NULL when off
+    TraceReader* replay;                   // replaying, NULL when off
+    bool replay_done;                      // trace used up or diverged
+    int trace_config[TRACE_CONFIG_INTS];   // settings last written to the trace
+    int trace_config_count;
+
+    // Snapshots (engineSetSnapshots)
+    int step_count;                        // engineStep() calls since the last reset
+    int snapshot_interval;                 // cycles between snapshots, 0 = off
+    int snapshot_limit;                    // snapshots kept before thinning out
+    int snapshot_period;                   // current spacing, doubles on every thinning
+    Snapshot* snapshots;                   // oldest first
+    int snapshot_count;
+    int snapshot_capacity;
+    InputRecord* inputs;                   // every input read, in clock order
+    int input_count;
+    int input_capacity;
+    int input_cursor;                      // next record a re-run cycle can reuse
+    bool rewinding;                        // re-running cycles after a restore: no
+                                           // log, output or update callbacks
+
+    // Policy state (Schedulers.c)
+    PCBQueue readyQueues[MAX_CPUS];                  // FCFS and Round Robin, per core
+    PCBQueue mlfqQueues[MAX_CPUS][MLFQ_MAX_LEVELS];  // level l of core c is mlfqQueues[c][l - 1]
+    uint64_t mlfqNonEmpty[MAX_CPUS];                 // bit l - 1 set while level l is non-empty
+    int mlfqBoostEpoch;                              // number of boosts so far
+    int mlfqNextBoost;                               // clock cycle of the next boost
+    RunTree cfsRunQueues[MAX_CPUS];                  // CFS runnable processes, by vruntime
+    long long cfsMinVruntime[MAX_CPUS];              // never decreases; newcomer placement
+    long long cfsQueuedWeight[MAX_CPUS];
+} Simulation;
+
+extern _Thread_local Simulation* sim; // current instance of the calling thread
+
+// -----------------------------------------------------------------------------
+// Engine API
+// -----------------------------------------------------------------------------
+Simulation* engineCreate(void);          // new empty instance with default settings
+void engineDestroy(Simulation* instance);
+void engineSelect(Simulation* instance); // make instance current for this thread
+void engineSetClient(const EngineClient* client);
+void engineInit(void);
+void engineReset(void);
+int engineAddProcess(const char* path, int arrival_time, int priority);
+bool engineHasUnfinished(void);
+void engineStep(void); // advance the simulation by one clock cycle
+void engineRun(void);
+const char* engineAlgorithmName(SchedulingAlgorithm algorithm);
+double engineFairnessIndex(void);
+double engineMaxSlowdown(void);
+bool engineSetCpuCount(int count);
+bool engineSetDisk(int latency, int depth); // latency 0 = file instructions are instant
+bool engineSetDiskPolicy(DiskPolicy policy);
+bool engineLoadFile(const char* path);   // host file programs start from
+void engineUseFiles(const FileSet* files); // share loaded files; NULL = own
+const FileSet* engineLoadedFiles(void);
+bool engineSyncFiles(void);              // write changed files to the host
+double engineDiskUtilization(void);      // fraction of cycles the disk was busy
+double engineIoOverlap(void);            // fraction of busy disk cycles a core ran too
+bool engineStartTrace(const char* path);
+bool engineStopTrace(void);
+bool engineStartReplay(const char* path);
+void engineStopReplay(void);
+bool engineSetSnapshots(int interval, int limit); // interval 0 turns them off
+bool engineStepBack(void);               // undo the last engineStep()
+bool engineRestoreCycle(int cycle);      // return to an earlier clock cycle
+void engineUseInputClient(void);         // ask EngineClient.read_input (default)
+bool engineSetInputFile(const char* path); // values file
+void engineSetInputGenerator(unsigned seed, int min, int max);
+void engineSetInputStream(FILE* stream); // e.g. stdin, one value per line
+void engineUseOutputClient(void);        // EngineClient.show_output (default)
+void engineSetOutputRing(int bytes);     // keep the last bytes of each process
+bool engineSetOutputFile(const char* path);
+void engineSetOutputStream(FILE* stream); // e.g. stdout
+bool engineFlushOutput(void);            // false if program output could not be written
+double engineCoreUtilization(int cpu);
+const char* engineMetricName(Metric metric);
+const Histogram* engineMetric(Metric metric);
+bool engineWriteMetrics(const char* path); // one CSV row per process
+void engineLog(const char* message);
+const EngineChanges* engineChanges(void);
+void engineClearChanges(void);
+void engineMarkChanged(unsigned flags);
+void engineMarkProcess(int index);
+void engineMarkWord(int address);
+
+// -----------------------------------------------------------------------------
+// Backend functions
+// -----------------------------------------------------------------------------
+Resource* mutex_converter(char* name);
+bool signalMutex(Resource* m);
+bool waitMutex(Resource* m, PCB* pcb);
+void setVariable(PCB* process, int slot, const char* value);
+char* getVariable(PCB* process, int slot);
+int countInstructions(const char *filename);
+bool compileProgram(PCB* process);
+void executeInstruction(const Instruction* ins, PCB* process);
+void executeCurrentInstruction(PCB* process);
+void makeReady(PCBQueue* q, int index);
+void engineUnblock(int index);
+
+#endif // ENGINE_H
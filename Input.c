@@ -0,0 +1,149 @@
+// Input.c
+// Values for "assign x input" from a values file, a generator or a stream
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "Input.h"
+#include "Storage.h"
+
+#define INPUT_LINE_LENGTH 1024
+#define INPUT_MAX_VALUES (1 << 24)
+
+void inputFree(InputSource* source) {
+    for (int i = 0; i < source->value_count; i++)
+        free(source->values[i]);
+    free(source->values);
+    free(source->start);
+    free(source->cursor);
+    memset(source, 0, sizeof(InputSource));
+}
+
+// PID of a "3: value" line (0 for a shared line); *text is moved to the value
+static int lineOwner(char** text) {
+    char* p = *text;
+    if (!isdigit((unsigned char)*p))
+        return 0;
+    long pid = strtol(p, &p, 10);
+    if (*p != ':' || (p[1] != ' ' && p[1] != '\t') || pid < 1 || pid >= INPUT_MAX_VALUES)
+        return 0;
+    p++;
+    while (*p == ' ' || *p == '\t')
+        p++;
+    *text = p;
+    return (int)pid;
+}
+
+bool inputLoadFile(InputSource* source, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+        return false;
+
+    // Read every line with its owner, then group the values by owner
+    InputSource loaded = { .kind = INPUT_VALUES };
+    char** values = NULL;
+    int* owners = NULL;
+    int capacity = 0, owner_capacity = 0, count = 0, owner_count = 1;
+    char line[INPUT_LINE_LENGTH];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char* text = line;
+        int owner = lineOwner(&text);
+        ok = growArray((void**)&values, &capacity, count + 1, INPUT_MAX_VALUES, sizeof(char*)) &&
+             growArray((void**)&owners, &owner_capacity, count + 1, INPUT_MAX_VALUES, sizeof(int)) &&
+             (values[count] = strdup(text)) != NULL;
+        if (ok) {
+            owners[count++] = owner;
+            if (owner + 1 > owner_count)
+                owner_count = owner + 1;
+        }
+    }
+    fclose(file);
+
+    loaded.value_count = count;
+    loaded.owner_count = owner_count;
+    ok = ok && (loaded.values = malloc((count > 0 ? count : 1) * sizeof(char*))) != NULL &&
+         (loaded.start = calloc(owner_count + 1, sizeof(int))) != NULL &&
+         (loaded.cursor = malloc(owner_count * sizeof(int))) != NULL;
+    if (!ok) {
+        for (int i = 0; i < count; i++)
+            free(values[i]);
+        free(values);
+        free(owners);
+        loaded.value_count = 0;
+        inputFree(&loaded);
+        return false;
+    }
+
+    // Counting sort by owner keeps file order within each owner
+    for (int i = 0; i < count; i++)
+        loaded.start[owners[i] + 1]++;
+    for (int o = 0; o < owner_count; o++)
+        loaded.start[o + 1] += loaded.start[o];
+    for (int o = 0; o < owner_count; o++)
+        loaded.cursor[o] = loaded.start[o];
+    for (int i = 0; i < count; i++)
+        loaded.values[loaded.cursor[owners[i]]++] = values[i];
+    free(values);
+    free(owners);
+
+    inputFree(source);
+    *source = loaded;
+    inputRewind(source);
+    return true;
+}
+
+void inputUseGenerator(InputSource* source, unsigned seed, int min, int max) {
+    inputFree(source);
+    source->kind = INPUT_GENERATOR;
+    source->seed = seed;
+    source->min = min < max ? min : max;
+    source->max = min < max ? max : min;
+}
+
+void inputUseStream(InputSource* source, FILE* stream) {
+    inputFree(source);
+    source->kind = INPUT_STREAM;
+    source->stream = stream;
+}
+
+void inputRewind(InputSource* source) {
+    if (source->kind != INPUT_VALUES)
+        return;
+    for (int o = 0; o < source->owner_count; o++)
+        source->cursor[o] = source->start[o];
+}
+
+// SplitMix64 finalizer: a well mixed 64-bit value for every input
+static unsigned long long mix(unsigned long long x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+bool inputNext(InputSource* source, int pid, int reads, char* out, int out_size) {
+    switch (source->kind) {
+    case INPUT_VALUES: {
+        int owner = pid > 0 && pid < source->owner_count &&
+                    source->cursor[pid] < source->start[pid + 1] ? pid : 0;
+        if (source->cursor[owner] >= source->start[owner + 1])
+            return false;
+        snprintf(out, out_size, "%s", source->values[source->cursor[owner]++]);
+        return true;
+    }
+    case INPUT_GENERATOR: {
+        unsigned long long x = mix(((unsigned long long)source->seed << 32) ^
+                                   mix(((unsigned long long)(unsigned)pid << 32) | (unsigned)reads));
+        long long range = (long long)source->max - source->min + 1;
+        snprintf(out, out_size, "%lld", source->min + (long long)(x % (unsigned long long)range));
+        return true;
+    }
+    case INPUT_STREAM:
+        if (source->stream == NULL || !fgets(out, out_size, source->stream))
+            return false;
+        out[strcspn(out, "\r\n")] = '\0';
+        return true;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,50 @@
+// Input.h - Where values for "assign x input" come from when no one is asked
+// interactively: a values file, a deterministic generator or a text stream
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+typedef enum {
+    INPUT_CLIENT = 0, // ask the front end (EngineClient.read_input)
+    INPUT_VALUES,     // values file, see inputLoadFile()
+    INPUT_GENERATOR,  // pseudo-random integers from a seed
+    INPUT_STREAM      // one line per value from an open stream, e.g. stdin
+} InputKind;
+
+// A zeroed InputSource asks the front end
+typedef struct {
+    InputKind kind;
+
+    // INPUT_VALUES: values grouped by owner (0 = any process, else a PID) in
+    // file order; owner o's values are values[start[o] .. start[o + 1])
+    char** values;
+    int value_count;
+    int* start;          // owner_count + 1 entries
+    int* cursor;         // next unused value of each owner
+    int owner_count;     // highest PID in the file + 1
+
+    // INPUT_GENERATOR
+    unsigned seed;
+    int min, max;
+
+    // INPUT_STREAM (not owned)
+    FILE* stream;
+} InputSource;
+
+// Values file: one value per line, used in order by whichever process asks
+// next. A line "3: value" (PID, colon, blank) is reserved for process 3,
+// which uses its own lines before the shared ones.
+bool inputLoadFile(InputSource* source, const char* path);
+void inputUseGenerator(InputSource* source, unsigned seed, int min, int max);
+void inputUseStream(InputSource* source, FILE* stream);
+void inputFree(InputSource* source);   // back to asking the front end
+void inputRewind(InputSource* source); // start the values file over
+
+// Next value for process `pid`, which has read `reads` values so far.
+// Generated values depend only on seed, PID and `reads`, so they do not
+// change with the scheduling order. False when the source has no value.
+bool inputNext(InputSource* source, int pid, int reads, char* out, int out_size);
+
+#endif // INPUT_H
@@ -1,51 +1,614 @@
+// MS2.c - Headless simulation core: engine state, instruction execution and the
+// dispatch loop that hands processes to the policies in Schedulers.c
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
-#include "Queues.h"
 #include <stdio.h>
-#include <glib.h>
-
-
-// Global variables
-extern PCB processes[MAX_PROCESSES];
-extern int process_count;
-extern MemoryWord memory[MEMORY_SIZE];
-extern int clock_cycle;
-extern SchedulingAlgorithm current_algorithm;
-extern int quantum;
-extern Resource resources[3]; // userInput, userOutput, file
-extern int running_process_index;
-extern int ready_queue[MAX_PROCESSES];
-extern int ready_queue_count;
-extern int blocked_queue[MAX_PROCESSES];
-extern int blocked_queue_count;
-extern gboolean simulation_running;
-extern int mode;
-extern int filecount;
-extern char file_names[MAX_PROCESSES][256];
-extern bool step;
-extern int idleCount;
-extern int quantum;
-//imported from backend vars
-extern PCBQueue firstLevelQueue;
-extern PCBQueue secondLevelQueue;
-extern PCBQueue thirdLevelQueue;
-extern PCBQueue readyQueue; // Also works as fourth queue in MLFQ (Round Robin)
-
-extern void executeInstructionUI(char* line, PCB* process);
-extern void append_log(const char* message);
+#include "Engine.h"
+#include "Storage.h"
+
+// Settings every new instance starts with
+#define SIMULATION_DEFAULTS {                   \
+    .current_algorithm = FCFS,                  \
+    .quantum = 2,                               \
+    .cpu_count = 1,                             \
+    .mlfq_level_count = MLFQ_DEFAULT_LEVELS,    \
+    .disk_queue_depth = DISK_DEFAULT_DEPTH,     \
+}
+
+// Instance used by threads that never select one (the GUI and batch runner)
+static Simulation defaultSimulation = SIMULATION_DEFAULTS;
+_Thread_local Simulation* sim = &defaultSimulation;
+
+// New empty instance with default settings; NULL when out of memory
+Simulation* engineCreate(void) {
+    Simulation* instance = malloc(sizeof(Simulation));
+    if (instance == NULL)
+        return NULL;
+    *instance = (Simulation)SIMULATION_DEFAULTS;
+
+    Simulation* previous = sim;
+    sim = instance;
+    engineInit();
+    sim = previous;
+    return instance;
+}
+
+static void dropSnapshots(int keep);
+
+// Release everything an instance owns, including the instance itself
+void engineDestroy(Simulation* instance) {
+    if (instance == NULL)
+        return;
+    Simulation* previous = sim;
+    sim = instance;
+    engineStopTrace();
+    engineStopReplay();
+    dropSnapshots(0);
+    free(sim->snapshots);
+    free(sim->inputs);
+    inputFree(&sim->input);
+    outputFree(&sim->output);
+    freeFileTable(&sim->files);
+    freeFileSet(&sim->host_files);
+    freeDisk(&sim->disk);
+    for (int i = 0; i < 3; i++) {
+        freeMinPQ(sim->resources[i].blocked);
+        free(sim->resources[i].blocked);
+    }
+    freeArrivalQueue(&sim->pendingArrivals);
+    const SchedulerOps* policies[] = { &fcfsScheduler, &mlfqScheduler, &cfsScheduler };
+    for (int i = 0; i < 3; i++)
+        policies[i]->reset();
+    freeArena(&sim->arena);
+    free(sim->processes);
+    free(sim->memory);
+    free(sim->changes.processes);
+    free(sim->changes.words);
+    sim = previous == instance ? &defaultSimulation : previous;
+    if (instance != &defaultSimulation)
+        free(instance);
+}
+
+// Make instance the current simulation of the calling thread
+void engineSelect(Simulation* instance) {
+    sim = instance ? instance : &defaultSimulation;
+}
+
+void engineSetClient(const EngineClient* c) {
+    if (c)
+        sim->client = *c;
+    else
+        memset(&sim->client, 0, sizeof(sim->client));
+}
+
+void engineLog(const char* message) {
+    if (sim->client.log && !sim->rewinding)
+        sim->client.log(message);
+}
+
+static void engineNotifyUpdate(void) {
+    if (sim->client.on_update && !sim->rewinding)
+        sim->client.on_update();
+}
+
+const EngineChanges* engineChanges(void) {
+    return &sim->changes;
+}
+
+void engineClearChanges(void) {
+    for (int i = 0; i < sim->changes.process_count; i++)
+        if (sim->changes.processes[i] < sim->process_count)
+            sim->processes[sim->changes.processes[i]].dirty = false;
+    for (int i = 0; i < sim->changes.word_count; i++)
+        if (sim->changes.words[i] < sim->memory_size)
+            sim->memory[sim->changes.words[i]].dirty = false;
+    sim->changes.flags = 0;
+    sim->changes.process_count = 0;
+    sim->changes.word_count = 0;
+}
+
+void engineMarkChanged(unsigned flags) {
+    sim->changes.flags |= flags;
+}
+
+void engineMarkProcess(int index) {
+    if (sim->processes[index].dirty)
+        return;
+    // If the list cannot grow, fall back to a full refresh
+    if (!growArray((void**)&sim->changes.processes, &sim->changes.process_capacity,
+                   sim->changes.process_count + 1, process_limit, sizeof(int))) {
+        sim->changes.flags |= CHANGED_ALL;
+        return;
+    }
+    sim->processes[index].dirty = true;
+    sim->changes.processes[sim->changes.process_count++] = index;
+}
+
+void engineMarkWord(int address) {
+    if (sim->memory[address].dirty)
+        return;
+    if (!growArray((void**)&sim->changes.words, &sim->changes.word_capacity,
+                   sim->changes.word_count + 1, process_limit * WORDS_PER_PROCESS, sizeof(int))) {
+        sim->changes.flags |= CHANGED_ALL;
+        return;
+    }
+    sim->memory[address].dirty = true;
+    sim->changes.words[sim->changes.word_count++] = address;
+}
+
+// -----------------------------------------------------------------------------
+// Execution trace (Trace.h). While recording, scheduling events and the
+// effects of instructions (memory writes, semWait, semSignal) are written to
+// the trace. Replay runs the normal dispatch loop but applies the recorded
+// effects instead of executing instructions, and checks every scheduling
+// event it produces against the trace.
+// -----------------------------------------------------------------------------
+
+static int loadProgram(char* const* lines, int line_count, int arrival_time, int priority);
+static void submitRequest(PCB* process, DiskRequest* request);
+
+static void replayDiverged(void) {
+    char log_msg[96];
+    sprintf(log_msg, "Replay diverged from the trace at cycle %d", sim->clock_cycle);
+    engineLog(log_msg);
+    sim->replay_done = true;
+}
+
+// Record an event, or while replaying check that it matches the trace
+static void traceEvent(TraceEventType type, int index, int arg) {
+    int ints[2] = { index, arg };
+    if (sim->trace) {
+        traceWrite(sim->trace, sim->clock_cycle, type, ints, 2, NULL, 0);
+    } else if (sim->replay && !sim->replay_done) {
+        const TraceEvent* e = tracePeek(sim->replay);
+        if (e && e->clock == sim->clock_cycle && e->type == type && e->int_count == 2 &&
+            e->ints[0] == index && e->ints[1] == arg)
+            traceConsume(sim->replay);
+        else
+            replayDiverged();
+    }
+}
+
+// Scheduling settings of an instance as a list of ints; returns the count
+static int settingsOf(const Simulation* s, int ints[TRACE_CONFIG_INTS]) {
+    int n = 0;
+    ints[n++] = s->cpu_count;
+    ints[n++] = s->current_algorithm;
+    ints[n++] = s->quantum;
+    ints[n++] = s->fast_forward_idle;
+    ints[n++] = s->mlfq_boost_interval;
+    ints[n++] = s->mlfq_level_count;
+    for (int l = 0; l < s->mlfq_level_count; l++)
+        ints[n++] = s->mlfq_quanta[l];
+    ints[n++] = s->disk_latency;
+    ints[n++] = s->disk_queue_depth;
+    ints[n++] = s->disk_policy;
+    return n;
+}
+
+// Record the scheduling settings when they differ from the last recorded ones
+static void traceConfig(void) {
+    int ints[TRACE_CONFIG_INTS];
+    int n = settingsOf(sim, ints);
+    if (n == sim->trace_config_count && memcmp(ints, sim->trace_config, n * sizeof(int)) == 0)
+        return;
+    memcpy(sim->trace_config, ints, n * sizeof(int));
+    sim->trace_config_count = n;
+    traceWrite(sim->trace, sim->clock_cycle, TRACE_CONFIG, ints, n, NULL, 0);
+}
+
+static bool replayConfig(const TraceEvent* e) {
+    const int* v = e->ints;
+    if (e->int_count < 6 || v[5] < 1 || v[5] > MLFQ_MAX_LEVELS ||
+        e->int_count != 9 + v[5] || schedulerFor((SchedulingAlgorithm)v[1]) == NULL)
+        return false;
+    if (v[0] != sim->cpu_count && !engineSetCpuCount(v[0]))
+        return false;
+    if (!engineSetDisk(v[6 + v[5]], v[7 + v[5]]) ||
+        !engineSetDiskPolicy((DiskPolicy)v[8 + v[5]]))
+        return false;
+    sim->current_algorithm = (SchedulingAlgorithm)v[1];
+    sim->quantum = v[2];
+    sim->fast_forward_idle = v[3];
+    sim->mlfq_boost_interval = v[4];
+    bool defaults = true;
+    for (int l = 0; l < v[5]; l++)
+        if (v[6 + l] > 0)
+            defaults = false;
+    return mlfqConfigure(v[5], defaults ? NULL : v + 6);
+}
+
+static bool replayLoad(const TraceEvent* e) {
+    char* lines[MAX_INSTRUCTIONS];
+    int count = e->string_count < MAX_INSTRUCTIONS ? e->string_count : MAX_INSTRUCTIONS;
+    if (e->int_count != 2)
+        return false;
+    for (int i = 0; i < count; i++) {
+        lines[i] = arenaIntern(&sim->arena, e->strings[i]);
+        if (lines[i] == NULL)
+            return false;
+    }
+    return loadProgram(lines, count, e->ints[0], e->ints[1]) >= 0;
+}
+
+// Apply the loads and setting changes recorded before this cycle ran.
+// False once the trace is used up.
+static bool replayPending(void) {
+    const TraceEvent* e;
+    while (!sim->replay_done && (e = tracePeek(sim->replay)) != NULL &&
+           e->clock <= sim->clock_cycle) {
+        if (e->type == TRACE_END) {
+            sim->replay_done = true;
+        } else if (e->type == TRACE_LOAD) {
+            if (!replayLoad(e))
+                replayDiverged();
+        } else if (e->type == TRACE_CONFIG) {
+            if (!replayConfig(e))
+                replayDiverged();
+        } else {
+            break;
+        }
+        traceConsume(sim->replay);
+    }
+    if (!sim->replay_done && tracePeek(sim->replay) == NULL)
+        sim->replay_done = true;
+    if (sim->replay_done) {
+        char log_msg[64];
+        sprintf(log_msg, "Replay finished at cycle %d", sim->clock_cycle);
+        engineLog(log_msg);
+    }
+    return !sim->replay_done;
+}
+
+// Apply a recorded variable write of a process and consume it
+static void replayWrite(PCB* process, const TraceEvent* e) {
+    int slot = e->ints[1];
+    if (e->string_count == 1 && slot >= 0 && slot < process->var_count) {
+        char log_msg[128];
+        setVariable(process, slot, e->strings[0]);
+        snprintf(log_msg, sizeof(log_msg), "Process %d: %s = '%s'",
+                 process->process_id, process->var_names[slot], e->strings[0]);
+        engineLog(log_msg);
+    }
+    traceConsume(sim->replay);
+}
+
+// Apply the variable writes recorded for a process at this cycle, e.g. the
+// result of a disk read that just completed
+static void replayWrites(PCB* process) {
+    int index = process->process_id - 1;
+    const TraceEvent* e;
+    while (!sim->replay_done && (e = tracePeek(sim->replay)) != NULL &&
+           e->clock == sim->clock_cycle && e->int_count == 2 && e->ints[0] == index &&
+           e->type == TRACE_WRITE)
+        replayWrite(process, e);
+}
+
+// Apply the recorded effects of the instruction a process runs this cycle,
+// without prompting for input, touching files or producing output. A disk
+// request is issued again for the recorded blocks but without a file, so it
+// takes the recorded time.
+static void replayInstruction(PCB* process) {
+    int index = process->process_id - 1;
+    const TraceEvent* e;
+    while (!sim->replay_done && (e = tracePeek(sim->replay)) != NULL &&
+           e->clock == sim->clock_cycle && e->int_count >= 2 && e->ints[0] == index &&
+           (e->type == TRACE_WRITE || e->type == TRACE_WAIT || e->type == TRACE_SIGNAL ||
+            e->type == TRACE_DISK)) {
+        TraceEventType type = e->type;
+        int arg = e->ints[1];
+        if (type == TRACE_WRITE) {
+            replayWrite(process, e);
+            continue;
+        }
+        if (type == TRACE_DISK) {
+            if (e->int_count != 3) {
+                replayDiverged();
+                return;
+            }
+            DiskRequest request = { .slot = -1, .start = arg, .blocks = e->ints[2] };
+            traceConsume(sim->replay);
+            if (request.start < 0 || request.blocks < 1) {
+                replayDiverged();
+                return;
+            }
+            submitRequest(process, &request); // checks the BLOCK event after it
+            return;
+        }
+        traceConsume(sim->replay);
+        if (arg < 0 || arg > 2) {
+            replayDiverged();
+            return;
+        }
+        if (type == TRACE_WAIT)
+            waitMutex(&sim->resources[arg], process);
+        else
+            signalMutex(&sim->resources[arg]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Snapshots. While enabled, engineStep() copies the run state every
+// snapshot_period cycles, and right away after processes were added or
+// settings changed, so every snapshot can be re-run up to the next one. When
+// snapshot_limit is reached every second periodic snapshot is dropped and the
+// period doubles, so the kept ones always span the whole run.
+// -----------------------------------------------------------------------------
+
+// Free the tables and queues a run state owns
+static void releaseState(Simulation* s) {
+    free(s->processes);
+    free(s->memory);
+    for (int i = 0; i < 3; i++) {
+        if (s->resources[i].blocked) {
+            freeMinPQ(s->resources[i].blocked);
+            free(s->resources[i].blocked);
+        }
+    }
+    freeArrivalQueue(&s->pendingArrivals);
+    freeFileTable(&s->files);
+    freeDisk(&s->disk);
+    for (int c = 0; c < MAX_CPUS; c++) {
+        freeQueue(&s->readyQueues[c]);
+        for (int l = 0; l < MLFQ_MAX_LEVELS; l++)
+            freeQueue(&s->mlfqQueues[c][l]);
+        freeRunTree(&s->cfsRunQueues[c]);
+    }
+}
+
+// Copy of an instance that owns its own copy of every table and queue;
+// NULL when out of memory
+static Simulation* copyState(const Simulation* from) {
+    Simulation* s = malloc(sizeof(Simulation));
+    if (s == NULL)
+        return NULL;
+    *s = *from;
+
+    // Detach every table before copying, so a failed copy can be released
+    s->processes = NULL;
+    s->memory = NULL;
+    for (int i = 0; i < 3; i++)
+        s->resources[i].blocked = NULL;
+    initArrivalQueue(&s->pendingArrivals);
+    memset(&s->files, 0, sizeof(FileTable));
+    memset(&s->disk, 0, sizeof(Disk));
+    for (int c = 0; c < MAX_CPUS; c++) {
+        initQueue(&s->readyQueues[c]);
+        for (int l = 0; l < MLFQ_MAX_LEVELS; l++)
+            initQueue(&s->mlfqQueues[c][l]);
+        initRunTree(&s->cfsRunQueues[c]);
+    }
+
+    s->process_capacity = s->process_count;
+    s->memory_capacity = s->memory_size;
+    bool ok = copyArray((void**)&s->processes, from->processes, from->process_count, sizeof(PCB)) &&
+              copyArray((void**)&s->memory, from->memory, from->memory_size, sizeof(MemoryWord)) &&
+              copyArrivalQueue(&s->pendingArrivals, &from->pendingArrivals) &&
+              copyFileTable(&s->files, &from->files) &&
+              copyDisk(&s->disk, &from->disk);
+    for (int i = 0; ok && i < 3; i++) {
+        s->resources[i].blocked = malloc(sizeof(PCBMinPQ));
+        ok = s->resources[i].blocked && copyMinPQ(s->resources[i].blocked, from->resources[i].blocked);
+    }
+    for (int c = 0; ok && c < MAX_CPUS; c++) {
+        ok = copyQueue(&s->readyQueues[c], &from->readyQueues[c]) &&
+             copyRunTree(&s->cfsRunQueues[c], &from->cfsRunQueues[c]);
+        for (int l = 0; ok && l < MLFQ_MAX_LEVELS; l++)
+            ok = copyQueue(&s->mlfqQueues[c][l], &from->mlfqQueues[c][l]);
+    }
+    if (!ok) {
+        releaseState(s);
+        free(s);
+        return NULL;
+    }
+
+    // A restored state starts with nothing pending for the front end
+    for (int i = 0; i < s->process_count; i++)
+        s->processes[i].dirty = false;
+    for (int i = 0; i < s->memory_size; i++)
+        s->memory[i].dirty = false;
+    return s;
+}
+
+// Drop every snapshot from position `keep` on
+static void dropSnapshots(int keep) {
+    for (int i = keep; i < sim->snapshot_count; i++) {
+        releaseState(sim->snapshots[i].state);
+        free(sim->snapshots[i].state);
+    }
+    if (keep < sim->snapshot_count)
+        sim->snapshot_count = keep;
+}
+
+// Drop every second periodic snapshot and double the period
+static void thinSnapshots(void) {
+    int kept = 0;
+    bool drop = false;
+    for (int i = 0; i < sim->snapshot_count; i++) {
+        Snapshot snapshot = sim->snapshots[i];
+        if (i > 0 && !snapshot.forced && (drop = !drop)) {
+            releaseState(snapshot.state);
+            free(snapshot.state);
+            continue;
+        }
+        sim->snapshots[kept++] = snapshot;
+    }
+    sim->snapshot_count = kept;
+    sim->snapshot_period *= 2;
+}
+
+// Called before every cycle: take a snapshot when one is due
+static void snapshotIfDue(void) {
+    const Simulation* last = sim->snapshot_count > 0 ?
+                             sim->snapshots[sim->snapshot_count - 1].state : NULL;
+    bool forced = last == NULL || last->process_count != sim->process_count;
+    if (!forced) {
+        int now[TRACE_CONFIG_INTS], then[TRACE_CONFIG_INTS];
+        int n = settingsOf(sim, now);
+        forced = n != settingsOf(last, then) || memcmp(now, then, n * sizeof(int)) != 0;
+    }
+    if (!forced && sim->clock_cycle < last->clock_cycle + sim->snapshot_period)
+        return;
+    if (sim->snapshot_count >= sim->snapshot_limit && !forced) {
+        thinSnapshots();
+        if (sim->snapshot_count >= sim->snapshot_limit)
+            return; // every snapshot left is forced
+    }
+
+    Simulation* state = NULL;
+    if (!growArray((void**)&sim->snapshots, &sim->snapshot_capacity, sim->snapshot_count + 1,
+                   process_limit, sizeof(Snapshot)) ||
+        (state = copyState(sim)) == NULL) {
+        engineLog("Error: Out of memory for a snapshot");
+        return;
+    }
+    sim->snapshots[sim->snapshot_count].state = state;
+    sim->snapshots[sim->snapshot_count].forced = forced;
+    sim->snapshot_count++;
+}
+
+// Value for "assign x input" from the input source, or from the front end
+// when there is none. With snapshots on every value is kept, and a re-run
+// cycle gets the value it read the first time instead of asking again.
+static bool readInput(PCB* process, const char* variable, char* out, int out_size) {
+    int index = process->process_id - 1;
+    if (sim->snapshot_interval > 0) {
+        while (sim->input_cursor < sim->input_count &&
+               sim->inputs[sim->input_cursor].clock < sim->clock_cycle)
+            sim->input_cursor++;
+        InputRecord* record = sim->input_cursor < sim->input_count ?
+                              &sim->inputs[sim->input_cursor] : NULL;
+        if (record && record->clock == sim->clock_cycle && record->index == index) {
+            snprintf(out, out_size, "%s", record->value);
+            sim->input_cursor++;
+            process->inputs_read++;
+            return true;
+        }
+        // The remaining values belong to a run that went differently
+        sim->input_count = sim->input_cursor;
+    }
+    if (sim->input.kind != INPUT_CLIENT) {
+        if (!inputNext(&sim->input, process->process_id, process->inputs_read, out, out_size))
+            return false;
+    } else if (!sim->client.read_input || !sim->client.read_input(process, variable, out, out_size)) {
+        return false;
+    }
+    process->inputs_read++;
+    if (sim->snapshot_interval > 0 &&
+        growArray((void**)&sim->inputs, &sim->input_capacity, sim->input_count + 1,
+                  INT32_MAX, sizeof(InputRecord))) {
+        InputRecord* record = &sim->inputs[sim->input_count];
+        record->clock = sim->clock_cycle;
+        record->index = index;
+        record->value = arenaIntern(&sim->arena, out);
+        if (record->value != NULL) {
+            sim->input_count++;
+            sim->input_cursor = sim->input_count;
+        }
+    }
+    return true;
+}
+
+// Restore the newest snapshot taken no later than the given clock cycle and
+// step count, then re-run the cycles after it without output until one of
+// the two is reached
+static bool rewindTo(int clock, int steps) {
+    if (sim->replay || sim->snapshot_interval == 0)
+        return false;
+    int i = sim->snapshot_count - 1;
+    while (i >= 0 && (sim->snapshots[i].state->clock_cycle > clock ||
+                      sim->snapshots[i].state->step_count > steps))
+        i--;
+    if (i < 0)
+        return false;
+    Simulation* copy = copyState(sim->snapshots[i].state);
+    if (copy == NULL) {
+        engineLog("Error: Out of memory restoring a snapshot");
+        return false;
+    }
+
+    // A trace only describes one run straight through
+    if (sim->trace) {
+        engineStopTrace();
+        engineLog("Trace recording stopped: the simulation went back in time");
+    }
+
+    // Take over the run state; everything else stays with the instance
+    Simulation kept = *sim;
+    releaseState(sim);
+    *sim = *copy;
+    free(copy);
+    sim->client = kept.client;
+    sim->arena = kept.arena;
+    sim->changes = kept.changes;
+    sim->input = kept.input;
+    sim->output = kept.output;
+    sim->host_files = kept.host_files;
+    sim->shared_files = kept.shared_files;
+    sim->trace = NULL;
+    sim->replay = NULL;
+    sim->replay_done = kept.replay_done;
+    sim->snapshot_interval = kept.snapshot_interval;
+    sim->snapshot_limit = kept.snapshot_limit;
+    sim->snapshot_period = kept.snapshot_period;
+    sim->snapshots = kept.snapshots;
+    sim->snapshot_count = kept.snapshot_count;
+    sim->snapshot_capacity = kept.snapshot_capacity;
+    sim->inputs = kept.inputs;
+    sim->input_count = kept.input_count;
+    sim->input_capacity = kept.input_capacity;
+    dropSnapshots(i + 1);
+
+    // First input record at or after the restored cycle
+    int lo = 0, hi = sim->input_count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (sim->inputs[mid].clock < sim->clock_cycle)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    sim->input_cursor = lo;
+
+    sim->rewinding = true;
+    while (sim->clock_cycle < clock && sim->step_count < steps)
+        engineStep();
+    sim->rewinding = false;
+
+    sim->changes.process_count = 0;
+    sim->changes.word_count = 0;
+    for (int p = 0; p < sim->process_count; p++)
+        sim->processes[p].dirty = false;
+    for (int w = 0; w < sim->memory_size; w++)
+        sim->memory[w].dirty = false;
+    sim->changes.flags = CHANGED_ALL;
+    return true;
+}
+
 //global varunctions
 Resource* mutex_converter(char* name){
     if(strcmp(name,"userInput")==0){
         //printf("Mutex taken: input_mutex\n");
-        return &resources[0];
+        return &sim->resources[0];
     }else if(strcmp(name,"userOutput")==0){
         //return &output_mutex;
-        return &resources[1];
+        return &sim->resources[1];
     }else {
         //return &access_file_mutex;
-        return &resources[2];
+        return &sim->resources[2];
+    }
+}
+
+// Put a process on a ready queue; only fails when growing the queue fails
+void makeReady(PCBQueue* q, int index) {
+    engineMarkProcess(index);
+    engineMarkChanged(CHANGED_QUEUES);
+    if (!enqueuePCB(q, index)) {
+        char log_msg[96];
+        sprintf(log_msg, "Error: could not queue process %d, out of memory", index + 1);
+        engineLog(log_msg);
     }
 }
 
@@ -53,122 +616,83 @@ bool signalMutex(Resource* m) {
     if(m->available) {
         return false; // Error: signaling an unused mutex
     }
+    engineMarkChanged(CHANGED_RESOURCES);
     if(isMinPQEmpty(m->blocked)) {
         m->available = true;
-        m->holder_process = NULL;
-        printf("Mutex released\n");
+        m->holder = -1;
         return true;
     } else {
-        printf("started in signal if");
-        PCB* nextProcess = malloc(sizeof(PCB));
-        printf("passes pointer");
-        minPQPop(m->blocked, nextProcess);
-        nextProcess->state = READY ; // Ready state
-        m->holder_process = nextProcess;
-        if(current_algorithm == MULTILEVEL_FEEDBACK) {
-            printf("Process Current Queue is %d\n", nextProcess->currentMLFQueue);
-            if(nextProcess->currentMLFQueue == 1) {
-                if (nextProcess->shiftDown) {
-                    nextProcess->currentMLFQueue = 2;
-                    nextProcess->shiftDown = false;
-                    enqueuePCB(&secondLevelQueue, *nextProcess);
-                }
-                else enqueuePCB(&firstLevelQueue, *nextProcess);
-            } else if(nextProcess->currentMLFQueue == 2) {
-                if (nextProcess->shiftDown) {
-                    nextProcess->currentMLFQueue = 3;
-                    nextProcess->shiftDown = false;
-                    enqueuePCB(&thirdLevelQueue, *nextProcess);
-                }
-                else enqueuePCB(&secondLevelQueue, *nextProcess);
-            } else if(nextProcess->currentMLFQueue == 3) {
-                if (nextProcess->shiftDown) {
-                    nextProcess->currentMLFQueue = 4;
-                    nextProcess->shiftDown = false;
-                    enqueuePCB(&readyQueue, *nextProcess);
-                }
-                else enqueuePCB(&thirdLevelQueue, *nextProcess);
-            } else {
-                if (nextProcess->shiftDown) {
-                    nextProcess->currentMLFQueue = 4;
-                    nextProcess->shiftDown = false;
-                    enqueuePCB(&readyQueue, *nextProcess);
-                }
-                else enqueuePCB(&readyQueue, *nextProcess);
-            }
-        }else {
-            printf("trying to enqueu");
-            enqueuePCB(&readyQueue, *nextProcess);
-            printf("enqueue successful");
-        }
+        int index;
+        minPQPop(m->blocked, &index);
+        // Runs while the signalling process executes, so the woken one is
+        // ready from the next cycle on
+        PCB* p = &sim->processes[index];
+        p->state = READY;
+        p->blocked_cycles[m - sim->resources] += sim->clock_cycle + 1 - p->state_since;
+        p->state_since = sim->clock_cycle + 1;
+        m->holder = index;
+        traceEvent(TRACE_UNBLOCK, index, (int)(m - sim->resources));
+        engineUnblock(index);
         return true;
     }
 }
 
 bool waitMutex(Resource* m, PCB* pcb) {
     if(pcb == NULL) {
-        printf("Error: PCB is NULL\n");
+        engineLog("Error: PCB is NULL");
         return false;
     }
+    engineMarkChanged(CHANGED_RESOURCES);
     if(m->available) {
         m->available = false;
-        m->holder_process = pcb;
-        m->holder_process->state = READY;
-        printf("Process %d acquired mutex\n", pcb->process_id);
+        m->holder = pcb->process_id - 1;
         return true;
     } else {
-        minPQInsert(m->blocked, pcb);
+        if (!minPQInsert(m->blocked, pcb->process_id - 1, pcb->priority)) {
+            engineLog("Error: could not add process to the mutex wait queue, out of memory");
+            return false;
+        }
         pcb->state = BLOCKED;
-        printf("Process %d is blocked on mutex\n", pcb->process_id);
+        pcb->state_since = sim->clock_cycle + 1;
+        traceEvent(TRACE_BLOCK, pcb->process_id - 1, (int)(m - sim->resources));
+        char log_msg[128];
+        sprintf(log_msg, "Process %d is blocked on mutex %s", pcb->process_id, m->name);
+        engineLog(log_msg);
         return false;
     }
 }
-// Set Variable in memory
-void setVariable(PCB* process, char* name, char* value) {
-    // If variable already exists
-    for (int i = process->memory_lower_bound; i < process->memory_upper_bound; i++) {
-        if (memory[i].allocated && strcmp(memory[i].name, name) == 0) {
-            memory[i].value = value;
-            return;
-        }
+// Set Variable in memory. Slot ids are resolved at load time, so a
+// variable lives at a fixed address inside the process's memory segment.
+void setVariable(PCB* process, int slot, const char* value) {
+    if (slot < 0 || slot >= process->var_count)
+        return;
+    char* copy = arenaIntern(&sim->arena, value);
+    if (copy == NULL)
+        return;
+    MemoryWord* word = &sim->memory[process->var_base + slot];
+    // First assignment: the word takes the variable's name
+    if (!(process->var_assigned & (1u << slot))) {
+        word->name = process->var_names[slot];
+        process->var_assigned |= 1u << slot;
     }
-    // If variable does not exist
-    for (int i = process->memory_lower_bound; i < process->memory_upper_bound; i++) {
-        if (strcmp(memory[i].value, "NULL") == 0) {
-            memory[i].name = strdup(name);
-            memory[i].value = strdup(value);
-            memory[i].allocated = 1;
-            return;
-        }
+    word->value = copy;
+    engineMarkWord(process->var_base + slot);
+    if (sim->trace) {
+        int ints[2] = { process->process_id - 1, slot };
+        traceWrite(sim->trace, sim->clock_cycle, TRACE_WRITE, ints, 2, &value, 1);
     }
 }
 
 
-// Get Variable from memory
-char* getVariable(PCB* process, char* name) {
-    for (int i = process->memory_lower_bound; i < process->memory_upper_bound; i++) {
-        if (memory[i].allocated && strcmp(memory[i].name, name) == 0) {
-            return memory[i].value;
-        }
-    }
-    return NULL;
+// Get Variable from memory, NULL if it was never assigned
+char* getVariable(PCB* process, int slot) {
+    if (slot < 0 || !(process->var_assigned & (1u << slot)))
+        return NULL;
+    return sim->memory[process->var_base + slot].value;
 }
 
 
 
-// File Reader
-void fileReader(const char* fileName, PCB* process) {
-    FILE* file = fopen(fileName, "r");
-    if (file == NULL)
-        printf("Error opening file\n");
-    else {
-        char line[256];
-        while (fgets(line, sizeof(line), file))
-            executeInstructionUI(line, process);
-    }
-    fclose(file);
-}
-
 int countInstructions(const char *filename) {
     
     FILE *file = fopen(filename, "r");
@@ -199,342 +723,1188 @@ int countInstructions(const char *filename) {
     return lines;
 }
 
-void executeLineFromFile(const char *filename, int program_counter, PCB *process) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        printf("Error opening file: %s\n", filename);
-        exit(1);
-    }
+// Map a resource name to its index in resources[] (same mapping as mutex_converter)
+static int resourceId(const char* name) {
+    if (strcmp(name, "userInput") == 0) return 0;
+    if (strcmp(name, "userOutput") == 0) return 1;
+    return 2;
+}
 
-    char line[256];
-    int current_line = 0;
+// Find the slot id of a variable, allocating a new slot on first use
+static int variableSlot(PCB* process, const char* name) {
+    for (int i = 0; i < process->var_count; i++) {
+        if (strcmp(process->var_names[i], name) == 0)
+            return i;
+    }
+    // Variables live after the State/PC/Priority and instruction words
+    if (process->var_count >= MAX_VARIABLES ||
+        3 + process->instruction_count + process->var_count >= WORDS_PER_PROCESS)
+        return -1;
+    process->var_names[process->var_count] = arenaIntern(&sim->arena, name);
+    if (process->var_names[process->var_count] == NULL)
+        return -1;
+    return process->var_count++;
+}
 
-    // Read the specific line corresponding to the program_counter
-    while (fgets(line, sizeof(line), file)) {
-        if (current_line == program_counter) {
-        executeInstructionUI(line, process); // Execute the instruction
-            break;
+// Decode one source line into an instruction
+static Instruction decodeInstruction(PCB* process, const char* line) {
+    Instruction ins = { OP_INVALID, -1, -1, -1, -1, NULL };
+    char command[20], arg1[20], arg2[20], arg3[20];
+    int parsed = sscanf(line, "%19s %19s %19s %19s", command, arg1, arg2, arg3);
+    if (parsed < 2)
+        return ins;
+
+    if (strcmp(command, "assign") == 0 && parsed >= 3) {
+        ins.dst = variableSlot(process, arg1);
+        if (strcmp(arg2, "input") == 0) {
+            ins.opcode = OP_ASSIGN_INPUT;
+        } else if (strcmp(arg2, "readFile") == 0) {
+            if (parsed < 4)
+                return ins;
+            ins.opcode = OP_ASSIGN_READFILE;
+            ins.src1 = variableSlot(process, arg3);
+        } else {
+            ins.opcode = OP_ASSIGN_VALUE;
+            ins.literal = arenaIntern(&sim->arena, arg2);
         }
-        current_line++;
+    } else if (strcmp(command, "printFromTo") == 0 && parsed >= 3) {
+        ins.opcode = OP_PRINT_FROM_TO;
+        ins.src1 = variableSlot(process, arg1);
+        ins.src2 = variableSlot(process, arg2);
+    } else if (strcmp(command, "print") == 0) {
+        ins.opcode = OP_PRINT;
+        ins.src1 = variableSlot(process, arg1);
+    } else if (strcmp(command, "writeFile") == 0 && parsed >= 3) {
+        ins.opcode = OP_WRITE_FILE;
+        ins.src1 = variableSlot(process, arg1);
+        ins.src2 = variableSlot(process, arg2);
+    } else if (strcmp(command, "readFile") == 0) {
+        ins.opcode = OP_READ_FILE;
+        ins.src1 = variableSlot(process, arg1);
+    } else if (strcmp(command, "semWait") == 0) {
+        ins.opcode = OP_SEM_WAIT;
+        ins.resource = resourceId(arg1);
+    } else if (strcmp(command, "semSignal") == 0) {
+        ins.opcode = OP_SEM_SIGNAL;
+        ins.resource = resourceId(arg1);
     }
+    // Running out of variable slots makes the instruction invalid
+    if (ins.dst == -1 && ins.opcode >= OP_ASSIGN_VALUE && ins.opcode <= OP_ASSIGN_READFILE)
+        ins.opcode = OP_INVALID;
+    return ins;
+}
 
-    fclose(file);
+// Compile the program text of a process into its opcode array (done once, at load time)
+bool compileProgram(PCB* process) {
+    process->var_count = 0;
+    process->var_assigned = 0;
+    process->var_base = process->memory_lower_bound + 3 + process->instruction_count;
+    process->code = arenaAlloc(&sim->arena, sizeof(Instruction) * (process->instruction_count > 0 ? process->instruction_count : 1));
+    if (process->code == NULL)
+        return false;
+    for (int i = 0; i < process->instruction_count; i++)
+        process->code[i] = decodeInstruction(process, process->program_instructions[i]);
+    return true;
 }
 
+// Program output is skipped while re-running cycles and when nobody takes it
+static bool outputWanted(void) {
+    return !sim->rewinding && (sim->output.kind != OUTPUT_CLIENT || sim->client.show_output);
+}
 
+// Finish an output; the front end gets the whole text, other sinks have it already
+static void endOutput(PCB* process) {
+    const char* text = outputEnd(&sim->output);
+    if (text && sim->client.show_output)
+        sim->client.show_output(process, text);
+}
 
-void fcfs() {
-    current_algorithm = FCFS;
-    static bool arrived [MAX_PROCESSES] = {false};
-    
-    static int finished_processes = 0;
+// -----------------------------------------------------------------------------
+// Files and the disk. Programs read and write simulated files, which start
+// out as the host files loaded with engineLoadFile() and reach the host only
+// through engineSyncFiles(), so a cycle never touches the host file system.
+// With a disk latency set, every file instruction becomes a disk request: the
+// process blocks, and the request takes effect when it completes.
+// -----------------------------------------------------------------------------
+
+// Host files the instance's programs see
+static const FileSet* hostFiles(void) {
+    return sim->shared_files ? sim->shared_files : &sim->host_files;
+}
 
+// Simulated file of a name, starting from the loaded host file on first use
+// when `load` is set; NULL when out of memory
+static SimFile* openFile(const char* name, bool load) {
+    char* interned = arenaIntern(&sim->arena, name);
+    if (interned == NULL)
+        return NULL;
+    SimFile* f = fileFind(&sim->files, interned);
+    if (f != NULL || (f = fileAdd(&sim->files, interned)) == NULL || !load)
+        return f;
+
+    const char* content = fileSetFind(hostFiles(), name);
+    if (content != NULL)
+        f->content = arenaIntern(&sim->arena, content);
+    return f;
+}
 
-    static int total_instructions[MAX_PROCESSES];
-    static int arrival_times[MAX_PROCESSES];
+// Carry out a file instruction: write `data`, or read into variable `slot`
+// (-1 = readFile, which only logs the first line)
+static void finishFileRequest(PCB* process, const char* name, const char* data, int slot) {
+    char log_msg[1128];
+    SimFile* f = name ? openFile(name, data == NULL) : NULL;
+    if (f == NULL) {
+        if (name)
+            engineLog("Error: Out of memory for a file");
+        return;
+    }
+    if (data != NULL) {
+        f->content = data;
+        f->dirty = true;
+        snprintf(log_msg, sizeof(log_msg), "Process %d: Wrote data to file %s", process->process_id, name);
+    } else if (slot >= 0) {
+        if (f->content == NULL) {
+            engineLog("Error opening file");
+            return;
+        }
+        setVariable(process, slot, f->content);
+        snprintf(log_msg, sizeof(log_msg), "Process %d: Read from file '%s' into variable %s",
+                 process->process_id, name, process->var_names[slot]);
+    } else if (f->content == NULL) {
+        snprintf(log_msg, sizeof(log_msg), "Process %d: Error reading file %s", process->process_id, name);
+    } else {
+        // First line, newline included, as fgets would return it
+        int length = (int)strcspn(f->content, "\n");
+        if (f->content[length] == '\n')
+            length++;
+        if (length > 999)
+            length = 999;
+        snprintf(log_msg, sizeof(log_msg), "Process %d read from file %s: %.*s",
+                 process->process_id, name, length, f->content);
+    }
+    engineLog(log_msg);
+}
 
-    // Count instructions in each program
-    for (int i = 0; i < process_count; i++) {
-        total_instructions[i] = processes[i].instruction_count;
+// Queue a disk request and block the process until it completes
+static void submitRequest(PCB* process, DiskRequest* request) {
+    request->index = process->process_id - 1;
+    request->submitted = sim->clock_cycle;
+    if (!diskSubmit(&sim->disk, request)) {
+        engineLog("Error: could not queue the disk request, out of memory");
+        return;
     }
-    // Count instructions in each program
-    for (int i = 0; i < process_count; i++) {
-        arrival_times[i] = processes[i].arrival_time;
+    diskStart(&sim->disk, sim->clock_cycle, sim->disk_latency, sim->disk_queue_depth,
+              sim->disk_policy);
+    process->state = BLOCKED;
+    process->state_since = sim->clock_cycle + 1;
+    engineMarkChanged(CHANGED_RESOURCES);
+    traceEvent(TRACE_BLOCK, request->index, DISK_RESOURCE);
+
+    char log_msg[384];
+    snprintf(log_msg, sizeof(log_msg), "Process %d is blocked on disk I/O%s%s (blocks %d-%d)",
+             process->process_id, request->name ? " for file " : "",
+             request->name ? request->name : "", request->start,
+             request->start + request->blocks - 1);
+    engineLog(log_msg);
+}
+
+// Carry out a file instruction now, or hand it to the disk and block the
+// process until the request completes. A file gets its blocks the first time
+// it is used, and new ones at the end of the disk when a write outgrows them.
+static void fileRequest(PCB* process, const char* name, const char* data, int slot) {
+    SimFile* f = sim->disk_latency > 0 ? openFile(name, data == NULL) : NULL;
+    if (f == NULL) {
+        finishFileRequest(process, name, data, slot);
+        return;
+    }
+    const char* content = data ? data : f->content;
+    int blocks = diskBlocksFor(content ? (int)strlen(content) : 0);
+    if (f->blocks < blocks) {
+        f->start = diskAllocate(&sim->disk, blocks);
+        f->blocks = blocks;
     }
+    DiskRequest request = {
+        .name = f->name,
+        .data = data,
+        .slot = slot,
+        .start = f->start,
+        .blocks = blocks
+    };
+    if (sim->trace) {
+        int ints[3] = { process->process_id - 1, request.start, request.blocks };
+        traceWrite(sim->trace, sim->clock_cycle, TRACE_DISK, ints, 3, NULL, 0);
+    }
+    submitRequest(process, &request);
+}
 
-    while (finished_processes < process_count) {
-        // Handle process arrivals
-        for (int i = 0; i < process_count; i++) {
-            if (arrival_times[i] == clock_cycle && !arrived[i]) {
-                arrived[i] = true;
-                processes[i].state = READY;
-                enqueuePCB(&readyQueue, processes[i]);
-            }
+// Execute one decoded instruction on behalf of a process
+void executeInstruction(const Instruction* ins, PCB* process) {
+    char* arg1 = ins->src1 >= 0 ? process->var_names[ins->src1] : NULL;
+    char* dst = ins->dst >= 0 ? process->var_names[ins->dst] : NULL;
+
+    switch (ins->opcode) {
+    case OP_ASSIGN_INPUT: {
+        char value[256];
+        if (readInput(process, dst, value, sizeof(value))) {
+            setVariable(process, ins->dst, value);
+            char log_msg[384];
+            sprintf(log_msg, "Process %d: Assigned user input '%s' to variable %s", 
+                    process->process_id, value, dst);
+            engineLog(log_msg);
         }
-        printQueue(&readyQueue);
-        if (!isQueueEmpty(&readyQueue)) {
-            idleCount = 0;
-            PCB current = readyQueue.data[readyQueue.head];
-            int pid = current.process_id - 1;
-            processes[pid].state = RUNNING;
-            running_process_index = current.process_id;
-            append_log("Reached this line");
-            executeLineFromFile(file_names[pid], processes[pid].program_counter, &processes[pid]);
-            append_log("Reached this line too");
-            processes[pid].program_counter++;
-
-            clock_cycle++;
-            // Check if process is finished
-            if (processes[pid].program_counter >= total_instructions[pid]) {
-                processes[pid].state = FINISHED;
-                finished_processes++;
-                dequeuePCB(&readyQueue, &current);
-                } else {
-                processes[pid].state = READY;
-            } 
-
-            // Debug pause if in step-by-step mode
-            if (mode == 2) {
-                printf("ready queue after exec");
-                printQueue(&readyQueue);
-                return;
+        break;
+    }
+    case OP_ASSIGN_READFILE: {
+        char* fileName = getVariable(process, ins->src1);
+        if (fileName == NULL) {
+            engineLog("Variable not found in memory");
+            return;
+        }
+        fileRequest(process, fileName, NULL, ins->dst);
+        break;
+    }
+    case OP_ASSIGN_VALUE: {
+        setVariable(process, ins->dst, ins->literal);
+        char log_msg[128];
+        sprintf(log_msg, "Process %d: Assigned value '%s' to variable %s", 
+                process->process_id, ins->literal, dst);
+        engineLog(log_msg);
+        break;
+    }
+    case OP_PRINT_FROM_TO: {
+        char* start_str = getVariable(process, ins->src1);
+        char* end_str = getVariable(process, ins->src2);
+        
+        if (!start_str || !end_str) {
+            engineLog("Error: Variables not found in memory");
+            return;
+        }
+        
+        int start = atoi(start_str);
+        int end = atoi(end_str);
+        
+        char log_msg[128];
+        sprintf(log_msg, "Process %d: Printing range %d to %d", process->process_id, start, end);
+        engineLog(log_msg);
+        if (outputWanted()) {
+            outputBegin(&sim->output, process->process_id);
+            for (long long i = start; i <= end; i++) {
+                outputWriteInt(&sim->output, i);
+                outputWrite(&sim->output, "\n", 1);
             }
-
-            // Handle arrivals during execution
-            for (int i = 0; i < process_count; i++) {
-                if (arrival_times[i] == clock_cycle && !arrived[i]) {
-                    arrived[i] = true;
-                    processes[i].state = READY;
-                    enqueuePCB(&readyQueue, processes[i]);
-                }
+            endOutput(process);
+        }
+        break;
+    }
+    case OP_PRINT: {
+        char* value = getVariable(process, ins->src1);
+        if (value != NULL) {
+            char log_msg[256];
+            snprintf(log_msg, sizeof(log_msg), "Process %d output: %s", process->process_id, value);
+            engineLog(log_msg);
+            if (outputWanted()) {
+                outputBegin(&sim->output, process->process_id);
+                outputWrite(&sim->output, value, (int)strlen(value));
+                endOutput(process);
             }
-            
-            
         } else {
-            append_log("No current Processes to run yet.");
-            clock_cycle++;
-            idleCount++;
-            if (mode == 2) {
-                printQueue(&readyQueue);
-                return;
-            }
+            char log_msg[256];
+            sprintf(log_msg, "Process %d: Error - Variable %s not found in memory", 
+                    process->process_id, arg1);
+            engineLog(log_msg);
+        }
+        break;
+    }
+    case OP_WRITE_FILE: {
+        char* fileName = getVariable(process, ins->src1);
+        char* data = getVariable(process, ins->src2);
+        
+        if (!fileName || !data) {
+            engineLog("Error: Variables not found in memory");
+            return;
+        }
+        fileRequest(process, fileName, data, -1);
+        break;
+    }
+    case OP_READ_FILE: {
+        char* fileName = getVariable(process, ins->src1);
+        if (!fileName) {
+            engineLog("Error: File name variable not found in memory");
+            return;
         }
+        fileRequest(process, fileName, NULL, -1);
+        break;
+    }
+    case OP_SEM_WAIT: {
+        char log_msg[128];
+        sprintf(log_msg, "Process %d: Waiting for mutex %s", process->process_id, sim->resources[ins->resource].name);
+        engineLog(log_msg);
+        traceEvent(TRACE_WAIT, process->process_id - 1, ins->resource);
+        waitMutex(&sim->resources[ins->resource], process);
+        break;
+    }
+    case OP_SEM_SIGNAL: {
+        char log_msg[128];
+        sprintf(log_msg, "Process %d: Signaling mutex %s", process->process_id, sim->resources[ins->resource].name);
+        engineLog(log_msg);
+        traceEvent(TRACE_SIGNAL, process->process_id - 1, ins->resource);
+        signalMutex(&sim->resources[ins->resource]);
+        break;
     }
-    append_log("All processes completed");
+    default:
+        engineLog("Invalid command format");
+        return;
+    }
+    
+    engineNotifyUpdate();
 }
 
-void roundRobin() {
-    current_algorithm = ROUND_ROBIN;
+// Execute the instruction at the process's program counter
+void executeCurrentInstruction(PCB* process) {
+    engineMarkProcess(process->process_id - 1);
+    if (sim->replay)
+        replayInstruction(process);
+    else
+        executeInstruction(&process->code[process->program_counter], process);
+}
 
-    static bool arrived[MAX_PROCESSES] = {false};
-    static int finished_processes = 0;
 
 
-    static int total_instructions[MAX_PROCESSES];
-    static int arrival_times[MAX_PROCESSES];
+// Policy the ready processes currently belong to
+static const SchedulerOps* activeScheduler(void) {
+    if (sim->scheduler == NULL)
+        sim->scheduler = schedulerFor(sim->current_algorithm);
+    return sim->scheduler;
+}
 
-    // Count instructions in each program
-    for (int i = 0; i < process_count; i++) {
-        total_instructions[i] = processes[i].instruction_count;
+// Follow a change of current_algorithm: hand every ready process over to the
+// new policy on the same core, in the order the old one would have run them
+static void switchScheduler(void) {
+    const SchedulerOps* next = schedulerFor(sim->current_algorithm);
+    const SchedulerOps* prev = activeScheduler();
+    if (next == NULL || next == prev)
+        return;
+    // Policies may share queues, so empty the old one completely first
+    PCBQueue handover[MAX_CPUS];
+    int index, slice;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        initQueue(&handover[c]);
+        while ((index = prev->pick_next(c, &slice)) >= 0)
+            makeReady(&handover[c], index);
     }
-    // Count instructions in each program
-    for (int i = 0; i < process_count; i++) {
-        arrival_times[i] = processes[i].arrival_time;
+    if (prev->reset)
+        prev->reset();
+
+    sim->scheduler = next;
+    if (next->reset)
+        next->reset();
+    for (int c = 0; c < sim->cpu_count; c++) {
+        while (dequeuePCB(&handover[c], &index))
+            next->on_arrival(c, index);
+        freeQueue(&handover[c]);
     }
+}
 
+// A process blocked on a mutex was handed the mutex; it wakes up on the
+// core it last ran on
+void engineUnblock(int index) {
+    int cpu = sim->processes[index].cpu;
+    sim->cores[cpu].queued++;
+    activeScheduler()->on_unblock(cpu, index);
+}
 
-    while (finished_processes < process_count) {
+// Core with the fewest queued and running processes, lowest number on ties
+static int leastLoadedCore(void) {
+    int best = 0, best_load = -1;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        int load = sim->cores[c].queued + (sim->cores[c].running >= 0);
+        if (best_load < 0 || load < best_load) {
+            best = c;
+            best_load = load;
+        }
+    }
+    return best;
+}
 
-        // Handle process arrivals
-        for (int i = 0; i < process_count; i++) {
-            if (arrival_times[i] == clock_cycle && !arrived[i]) {
-                arrived[i] = true;
-                processes[i].state = READY;
-                enqueuePCB(&readyQueue, processes[i]);
-            }
+// Move every process whose arrival time has come into its first ready queue
+static void admitArrivals(void) {
+    int i;
+    while (arrivalQueuePopDue(&sim->pendingArrivals, sim->clock_cycle, &i)) {
+        int cpu = leastLoadedCore();
+        sim->processes[i].state = READY;
+        sim->processes[i].state_since = sim->clock_cycle;
+        sim->processes[i].cpu = cpu;
+        sim->cores[cpu].queued++;
+        traceEvent(TRACE_ARRIVE, i, cpu);
+        activeScheduler()->on_arrival(cpu, i);
+    }
+}
+
+// Nothing is ready on any core: burn one idle cycle, or in fast-forward mode
+// jump the clock to the next arrival or disk completion and count the whole
+// skipped span as idle. While every core is idle nothing can signal a mutex,
+// so those are the only events that can make a process runnable again.
+static void idleUntilNextEvent(void) {
+    int next = arrivalQueueNextTime(&sim->pendingArrivals);
+    int done = diskNextCompletion(&sim->disk);
+    if (done >= 0 && (next < 0 || done < next))
+        next = done;
+    int span = 1;
+    if (sim->fast_forward_idle && next > sim->clock_cycle + 1) {
+        char log_msg[96];
+        sprintf(log_msg, "No current Processes to run yet, skipping to cycle %d.", next);
+        engineLog(log_msg);
+        span = next - sim->clock_cycle;
+    } else {
+        engineLog("No current Processes to run yet.");
+    }
+    if (sim->disk.active_count > 0)
+        sim->disk.busy_cycles += span;
+    sim->clock_cycle += span;
+    sim->idleCount += span;
+}
+
+// Give an idle core its next process: from its own run queue first, otherwise
+// stolen from the core with the longest queue
+static void dispatchCore(int cpu) {
+    const SchedulerOps* ops = activeScheduler();
+    Core* core = &sim->cores[cpu];
+    int index = ops->pick_next(cpu, &core->slice);
+    int from = cpu;
+
+    if (index < 0) {
+        int victim = -1;
+        for (int c = 0; c < sim->cpu_count; c++) {
+            if (c != cpu && sim->cores[c].queued > 0 &&
+                (victim < 0 || sim->cores[c].queued > sim->cores[victim].queued))
+                victim = c;
         }
+        if (victim < 0)
+            return;
+        index = ops->pick_next(victim, &core->slice);
+        if (index < 0)
+            return;
+        from = victim;
+        core->migrations++;
+        if (ops->on_migrate)
+            ops->on_migrate(victim, cpu, index);
+
+        char log_msg[96];
+        sprintf(log_msg, "Core %d stole process %d from core %d", cpu, index + 1, victim);
+        engineLog(log_msg);
+    }
+    sim->cores[from].queued--;
+    engineMarkProcess(index);
+    engineMarkChanged(CHANGED_QUEUES); // pulled off a ready queue
+    traceEvent(TRACE_DISPATCH, index, cpu);
+    core->running = index;
+    PCB* p = &sim->processes[index];
+    p->cpu = cpu;
+    p->state = RUNNING;
+    p->slice_used = 0;
+    p->ready_cycles += sim->clock_cycle - p->state_since;
+    p->context_switches++;
+    if (p->first_run < 0) {
+        p->first_run = sim->clock_cycle;
+        histogramAdd(&sim->metrics[METRIC_RESPONSE], p->first_run - p->arrival_time);
+    }
+}
 
-        printQueue(&readyQueue);
-
-        if (!isQueueEmpty(&readyQueue)) {
-            append_log("Haga bet run");
-            PCB current;
-            dequeuePCB(&readyQueue, &current);
-            PCB *currentProcess = &processes[current.process_id-1];
-            running_process_index = currentProcess->process_id;
-            currentProcess->state = RUNNING;
-
-            printf("Scheduling Process %d (quantum: %d)\n", currentProcess->process_id, quantum);
-
-            int quantum_used = 0;
-
-            while (quantum_used < quantum &&
-                   currentProcess->program_counter < total_instructions[currentProcess->process_id - 1] &&
-                   currentProcess->state != BLOCKED) {
-
-                    
-                executeLineFromFile(
-                    file_names[current.process_id-1],
-                    currentProcess->program_counter,
-                    currentProcess
-                );
-
-                currentProcess->program_counter++;
-                quantum_used++;
-
-                printf("Process %d executed instruction %d/%d\n",
-                       currentProcess->process_id,
-                       currentProcess->program_counter,
-                       total_instructions[currentProcess->process_id - 1]);
-                    //arrival of processes
-                for (int i = 0; i < process_count; i++) {
-                        if (arrival_times[i] == clock_cycle && !arrived[i]) {
-                            arrived[i] = true;
-                            processes[i].state = READY;
-                            enqueuePCB(&readyQueue, processes[i]);
-                        }
-                    }
-                    printQueue(&readyQueue);
-
-                clock_cycle++;
-
-                if (quantum_used < quantum && 
-                    currentProcess->program_counter < total_instructions[currentProcess->process_id - 1] &&
-                    currentProcess->state != BLOCKED) {
-                    //printf("\n<<<<<<<<<<<<<<<< [CLK %d] >>>>>>>>>>>>>>>>>>\n", clock_cycle);
-                }
-
-                if (currentProcess->state == BLOCKED) {
-                    printf("Process %d became BLOCKED.\n", currentProcess->process_id);
-                    return;
-                }
-
-                
-            }
-            if (currentProcess->state != BLOCKED) {
-                if (currentProcess->program_counter >= total_instructions[currentProcess->process_id - 1]) {
-                    currentProcess->state = FINISHED;
-                    finished_processes++;
-                    printf("Process %d completed at CLK %d\n", currentProcess->process_id, clock_cycle - 1);
-                } else {
-                    currentProcess->state = READY;
-                    enqueuePCB(&readyQueue, *currentProcess);
-                    printf("Process %d not finished, re-enqueued.\n", currentProcess->process_id);
-                }
-            }
-            if (mode == 2) {
-                printf("ready queue after exec");
-                printQueue(&readyQueue);
-                return;
-            }
+// Fold the counters of a process that just finished into the run's metrics
+static void recordCompletion(const PCB* p) {
+    int turnaround = p->finish_time - p->arrival_time;
+    int blocked = 0;
+    for (int r = 0; r < 3; r++)
+        blocked += p->blocked_cycles[r];
+    histogramAdd(&sim->metrics[METRIC_TURNAROUND], turnaround);
+    histogramAdd(&sim->metrics[METRIC_WAITING], turnaround - p->instruction_count);
+    histogramAdd(&sim->metrics[METRIC_READY], p->ready_cycles);
+    histogramAdd(&sim->metrics[METRIC_BLOCKED], blocked);
+    histogramAdd(&sim->metrics[METRIC_IO], p->io_cycles);
+    histogramAdd(&sim->metrics[METRIC_SWITCHES], p->context_switches);
+}
+
+// Wake the processes whose disk requests complete this cycle and start the
+// next waiting requests. A process whose last instruction was the request
+// finishes here; the policy already let go of it when it blocked.
+static void completeRequests(void) {
+    DiskRequest request;
+    while (diskPopCompleted(&sim->disk, sim->clock_cycle, &request)) {
+        PCB* p = &sim->processes[request.index];
+        p->io_cycles += sim->clock_cycle - p->state_since;
+        p->state_since = sim->clock_cycle;
+        engineMarkProcess(request.index);
+        engineMarkChanged(CHANGED_RESOURCES);
+        traceEvent(TRACE_UNBLOCK, request.index, DISK_RESOURCE);
+        if (sim->replay)
+            replayWrites(p);
+        else
+            finishFileRequest(p, request.name, request.data, request.slot);
+
+        if (p->program_counter >= p->instruction_count) {
+            p->state = FINISHED;
+            p->finish_time = sim->clock_cycle;
+            sim->finished_count++;
+            recordCompletion(p);
+            traceEvent(TRACE_FINISH, request.index, p->cpu);
         } else {
-            append_log("No current Processes to run yet.");
-            clock_cycle++;
-            idleCount++;
-            if (mode == 2) {
-                printQueue(&readyQueue);
-                return;
-            }
+            p->state = READY;
+            engineUnblock(request.index);
         }
     }
+    diskStart(&sim->disk, sim->clock_cycle, sim->disk_latency, sim->disk_queue_depth,
+              sim->disk_policy);
+}
 
-    append_log("All processes completed");
+// Execute one instruction on a core, then tell the policy why the process
+// left the core (if it did). Runs before the clock ticks, so a process that
+// finishes now completes at clock_cycle + 1.
+static void runCore(int cpu) {
+    const SchedulerOps* ops = activeScheduler();
+    Core* core = &sim->cores[cpu];
+    int index = core->running;
+    PCB* p = &sim->processes[index];
+
+    executeCurrentInstruction(p);
+    p->program_counter++;
+    p->slice_used++;
+    core->busy_cycles++;
+
+    if (p->state == BLOCKED) {
+        core->running = -1;
+        ops->on_block(cpu, index);
+    } else if (p->program_counter >= p->instruction_count) {
+        core->running = -1;
+        p->state = FINISHED;
+        p->finish_time = sim->clock_cycle + 1;
+        sim->finished_count++;
+        recordCompletion(p);
+        traceEvent(TRACE_FINISH, index, cpu);
+        ops->on_finish(cpu, index);
+    } else if (core->slice > 0 && p->slice_used >= core->slice) {
+        core->running = -1;
+        p->state = READY;
+        p->state_since = sim->clock_cycle + 1;
+        core->queued++;
+        traceEvent(TRACE_PREEMPT, index, cpu);
+        ops->on_quantum_expire(cpu, index);
+    }
 }
 
-void mlfq() {
-    current_algorithm = MULTILEVEL_FEEDBACK;
-    static bool arrived[MAX_PROCESSES] = {false};
-    static int finished_processes = 0;
-    static int total_instructions[MAX_PROCESSES];
-    static int arrival_times[MAX_PROCESSES];
+// Summary once the last process finishes
+static void logCompletion(void) {
+    char log_msg[128];
+    engineLog("All processes completed");
+    sprintf(log_msg, "Fairness index (Jain, over slowdown): %.3f, max slowdown: %.2f",
+            engineFairnessIndex(), engineMaxSlowdown());
+    engineLog(log_msg);
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        const Histogram* h = &sim->metrics[m];
+        sprintf(log_msg, "%s: mean %.2f, p50 %d, p95 %d, p99 %d, max %d", engineMetricName(m),
+                histogramMean(h), histogramPercentile(h, 50), histogramPercentile(h, 95),
+                histogramPercentile(h, 99), h->max);
+        engineLog(log_msg);
+    }
+    if (sim->disk.completed > 0) {
+        const Histogram* h = &sim->disk.latency;
+        snprintf(log_msg, sizeof(log_msg), "Disk (%s): %lld requests, seek distance %lld blocks, "
+                 "latency mean %.2f, p95 %d, max %d", diskPolicyName(sim->disk_policy),
+                 sim->disk.completed, sim->disk.seek_distance, histogramMean(h),
+                 histogramPercentile(h, 95), h->max);
+        engineLog(log_msg);
+    }
+    if (sim->cpu_count == 1)
+        return;
+    for (int c = 0; c < sim->cpu_count; c++) {
+        sprintf(log_msg, "Core %d: utilization %.1f%%, %d migrations",
+                c, engineCoreUtilization(c) * 100, sim->cores[c].migrations);
+        engineLog(log_msg);
+    }
+}
 
-    for (int i = 0; i < process_count; i++) {
-        total_instructions[i] = processes[i].instruction_count;
-        arrival_times[i] = processes[i].arrival_time;
+// Run one clock cycle: admit arrivals, complete disk requests, give every
+// idle core a process, then let each busy core execute one instruction in
+// core order
+static void dispatchCycle(void) {
+    bool busy = false;
+    int finished_before = sim->finished_count;
+
+    admitArrivals();
+    completeRequests();
+    if (finished_before < sim->process_count && sim->finished_count == sim->process_count) {
+        logCompletion();
+        return;
+    }
+    for (int c = 0; c < sim->cpu_count; c++) {
+        if (sim->cores[c].running < 0)
+            dispatchCore(c);
+        if (sim->cores[c].running >= 0)
+            busy = true;
+    }
+    if (!busy) {
+        idleUntilNextEvent();
+        return;
     }
 
-    while (finished_processes < process_count) {
-        // Arrival handling at the start of the cycle
-        for (int i = 0; i < process_count; i++) {
-            if (!arrived[i] && arrival_times[i] == clock_cycle) {
-                arrived[i] = true;
-                processes[i].state = READY;
-                processes[i].currentMLFQueue = 1;
-                enqueuePCB(&firstLevelQueue, processes[i]);
-            }
+    for (int c = 0; c < sim->cpu_count; c++) {
+        if (sim->cores[c].running >= 0)
+            runCore(c);
+    }
+    // Requests issued this cycle count as in service from this cycle on
+    if (sim->disk.active_count > 0) {
+        sim->disk.busy_cycles++;
+        sim->disk.overlap_cycles++;
+    }
+    sim->clock_cycle++;
+    if (finished_before < sim->process_count && sim->finished_count == sim->process_count)
+        logCompletion();
+}
+
+
+// -----------------------------------------------------------------------------
+// Engine API
+// -----------------------------------------------------------------------------
+
+// Set up resources, memory and queues for an empty simulation
+void engineInit(void) {
+    static char* names[3] = { "userInput", "userOutput", "file" };
+
+    for (int i = 0; i < 3; i++) {
+        PCBMinPQ* pq = malloc(sizeof(PCBMinPQ));
+        initMinPQ(pq);
+        sim->resources[i].name = names[i];
+        sim->resources[i].available = 1;
+        sim->resources[i].holder = -1;
+        sim->resources[i].blocked = pq;
+    }
+
+    // Tables start empty and grow as processes are added
+    sim->process_count = 0;
+    sim->finished_count = 0;
+    sim->memory_size = 0;
+
+    initArrivalQueue(&sim->pendingArrivals);
+
+    // Every core is idle and the selected policy starts empty
+    for (int c = 0; c < MAX_CPUS; c++) {
+        sim->cores[c].running = -1;
+        sim->cores[c].slice = 0;
+        sim->cores[c].queued = 0;
+        sim->cores[c].busy_cycles = 0;
+        sim->cores[c].migrations = 0;
+    }
+    if (sim->scheduler && sim->scheduler->reset)
+        sim->scheduler->reset();
+    for (int m = 0; m < METRIC_COUNT; m++)
+        histogramReset(&sim->metrics[m]);
+    sim->scheduler = schedulerFor(sim->current_algorithm);
+    if (sim->scheduler && sim->scheduler->reset)
+        sim->scheduler->reset();
+
+    // Front ends rebuild every view from scratch
+    sim->changes.process_count = 0;
+    sim->changes.word_count = 0;
+    sim->changes.flags = CHANGED_ALL;
+}
+
+// Throw away all processes and return to clock cycle 0
+void engineReset(void) {
+    // A trace only describes the run it started with
+    engineStopTrace();
+    engineStopReplay();
+
+    // Reset clock; snapshots and remembered input belong to the old run
+    sim->clock_cycle = 0;
+    sim->idleCount = 0;
+    sim->step_count = 0;
+    dropSnapshots(0);
+    sim->snapshot_period = sim->snapshot_interval;
+    sim->input_count = 0;
+    sim->input_cursor = 0;
+    inputRewind(&sim->input);
+    outputClear(&sim->output);
+
+    // Files written by the old run go too; loaded host files stay
+    freeFileTable(&sim->files);
+    freeDisk(&sim->disk);
+
+    // Release program text, decoded code and memory strings in one go;
+    // the tables keep their capacity
+    arenaReset(&sim->arena);
+
+    // Release the wait heaps and queues before engineInit() sets up fresh ones
+    for (int i = 0; i < 3; i++) {
+        freeMinPQ(sim->resources[i].blocked);
+        free(sim->resources[i].blocked);
+    }
+    freeArrivalQueue(&sim->pendingArrivals);
+
+    engineInit();
+}
+
+// Create a process from program lines already interned in the arena.
+// Returns the new PID or -1 on error.
+static int loadProgram(char* const* lines, int line_count, int arrival_time, int priority) {
+    if (sim->process_count >= process_limit) {
+        engineLog("Error: Maximum number of processes reached");
+        return -1;
+    }
+    // Grow the process table and simulated memory before building the PCB
+    if (!growArray((void**)&sim->processes, &sim->process_capacity, sim->process_count + 1,
+                   process_limit, sizeof(PCB)) ||
+        !growArray((void**)&sim->memory, &sim->memory_capacity, sim->memory_size + WORDS_PER_PROCESS,
+                   process_limit * WORDS_PER_PROCESS, sizeof(MemoryWord))) {
+        engineLog("Error: Out of memory for a new process");
+        return -1;
+    }
+
+    PCB new_process;
+    new_process.process_id = sim->process_count + 1;
+    new_process.state = READY;
+    new_process.priority = priority;
+    new_process.program_counter = 0;
+    new_process.memory_lower_bound = sim->memory_size;
+    new_process.memory_upper_bound = sim->memory_size + WORDS_PER_PROCESS - 1;
+    new_process.arrival_time = arrival_time;
+    new_process.currentMLFQueue = 0;
+    new_process.slice_used = 0;
+    new_process.boost_epoch = 0;
+    new_process.vruntime = 0;
+    new_process.first_run = -1;
+    new_process.finish_time = -1;
+    new_process.cpu = 0;
+    new_process.ready_cycles = 0;
+    for (int r = 0; r < 3; r++)
+        new_process.blocked_cycles[r] = 0;
+    new_process.io_cycles = 0;
+    new_process.context_switches = 0;
+    new_process.state_since = arrival_time;
+    new_process.inputs_read = 0;
+    new_process.shiftDown = false;
+
+    if (line_count > MAX_INSTRUCTIONS)
+        line_count = MAX_INSTRUCTIONS;
+    new_process.instruction_count = line_count;
+    for (int i = 0; i < MAX_INSTRUCTIONS; i++)
+        new_process.program_instructions[i] = i < line_count ? lines[i] : NULL;
+
+    // Decode the program once so the schedulers never touch the file again
+    if (!compileProgram(&new_process)) {
+        engineLog("Error: Memory allocation failed for decoded program");
+        return -1;
+    }
+
+    // Add process to list and index it by arrival time
+    if (!arrivalQueueInsert(&sim->pendingArrivals, arrival_time, sim->process_count)) {
+        engineLog("Error: Out of memory for a new process");
+        return -1;
+    }
+    new_process.dirty = false;
+    sim->processes[sim->process_count] = new_process;
+    sim->process_count++;
+    engineMarkProcess(sim->process_count - 1);
+
+    // Allocate memory for process
+    sim->memory_size += WORDS_PER_PROCESS;
+    for (int i = new_process.memory_lower_bound; i <= new_process.memory_upper_bound; i++) {
+        sim->memory[i].allocated = 1;
+        sim->memory[i].dirty = false;
+        engineMarkWord(i);
+
+        // Set memory values
+        if (i == new_process.memory_lower_bound) {
+            sim->memory[i].name = arenaIntern(&sim->arena, "State");
+            sim->memory[i].value = arenaIntern(&sim->arena, "Ready");
+        } else if (i == new_process.memory_lower_bound + 1) {
+            sim->memory[i].name = arenaIntern(&sim->arena, "PC");
+            sim->memory[i].value = arenaIntern(&sim->arena, "0");
+        } else if (i == new_process.memory_lower_bound + 2) {
+            sim->memory[i].name = arenaIntern(&sim->arena, "Priority");
+            char priority_str[16];
+            sprintf(priority_str, "%d", new_process.priority);
+            sim->memory[i].value = arenaIntern(&sim->arena, priority_str);
+        } else if (i < new_process.memory_lower_bound + 3 + new_process.instruction_count) {
+            char var_name[32];
+            sprintf(var_name, "Inst%d", i - new_process.memory_lower_bound - 2);
+            sim->memory[i].name = arenaIntern(&sim->arena, var_name);
+            sim->memory[i].value = new_process.program_instructions[i - new_process.memory_lower_bound - 3];
+        } else {
+            char var_name[32];
+            sprintf(var_name, "Var%d", i - new_process.memory_lower_bound - (new_process.instruction_count+2));
+            sim->memory[i].name = arenaIntern(&sim->arena, var_name);
+            sim->memory[i].value = arenaIntern(&sim->arena, "NULL");
         }
+    }
 
-        // Select process based on MLFQ level
-        PCB *currentProcess = NULL;
-        int quantum_length = 0;
-        int nextQueueLevel = 0;
-
-        if (!isQueueEmpty(&firstLevelQueue)) {
-            PCB temp; dequeuePCB(&firstLevelQueue, &temp);
-            currentProcess = &processes[temp.process_id - 1];
-            quantum_length = 1; nextQueueLevel = 2;
-        } else if (!isQueueEmpty(&secondLevelQueue)) {
-            PCB temp; dequeuePCB(&secondLevelQueue, &temp);
-            currentProcess = &processes[temp.process_id - 1];
-            quantum_length = 2; nextQueueLevel = 3;
-        } else if (!isQueueEmpty(&thirdLevelQueue)) {
-            PCB temp; dequeuePCB(&thirdLevelQueue, &temp);
-            currentProcess = &processes[temp.process_id - 1];
-            quantum_length = 4; nextQueueLevel = 4;
-        } else if (!isQueueEmpty(&readyQueue)) {
-            PCB temp; dequeuePCB(&readyQueue, &temp);
-            currentProcess = &processes[temp.process_id - 1];
-            quantum_length = 8; nextQueueLevel = 4;
+    if (sim->trace) {
+        int ints[2] = { arrival_time, priority };
+        traceWrite(sim->trace, sim->clock_cycle, TRACE_LOAD, ints, 2,
+                   (const char* const*)lines, line_count);
+    }
+    engineNotifyUpdate();
+    return new_process.process_id;
+}
+
+// Load a program file as a new process. Returns the new PID or -1 on error.
+int engineAddProcess(const char* path, int arrival_time, int priority) {
+    if (sim->replay) {
+        engineLog("Error: Cannot add processes while replaying a trace");
+        return -1;
+    }
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        engineLog("Error: Could not open program file");
+        return -1;
+    }
+
+    // Read instructions from file
+    char* lines[MAX_INSTRUCTIONS];
+    char line[256];
+    int idx = 0;
+    while (idx < MAX_INSTRUCTIONS && fgets(line, sizeof(line), file)) {
+        // Remove newline if present
+        size_t len = strlen(line);
+        if (len > 0 && line[len-1] == '\n') {
+            line[len-1] = '\0';
+        }
+        lines[idx] = arenaIntern(&sim->arena, line);
+        if (lines[idx] == NULL) {
+            engineLog("Error: Memory allocation failed for instruction");
+            fclose(file);
+            return -1;
         }
+        idx++;
+    }
+    fclose(file);
+    // An empty program has nothing to run; it would only take a cycle on a core
+    if (idx == 0) {
+        engineLog("Error: Program file has no instructions");
+        return -1;
+    }
+    return loadProgram(lines, idx, arrival_time, priority);
+}
 
-        if (currentProcess) {
-            currentProcess->state = RUNNING;
-            running_process_index = currentProcess->process_id;
-            int pid = currentProcess->process_id - 1;
-            int quantum_used = 0;
-
-            while (quantum_used < quantum_length &&
-                   currentProcess->program_counter < total_instructions[pid] &&
-                   currentProcess->state != BLOCKED) {
-
-                // Handle new arrivals during execution
-                for (int i = 0; i < process_count; i++) {
-                    if (!arrived[i] && arrival_times[i] == clock_cycle) {
-                        arrived[i] = true;
-                        processes[i].state = READY;
-                        processes[i].currentMLFQueue = 1;
-                        enqueuePCB(&firstLevelQueue, processes[i]);
-                    }
-                }
-
-                // If last cycle of quantum, mark for demotion
-                if (quantum_used == quantum_length - 1)
-                    currentProcess->shiftDown = true;
-
-                executeLineFromFile(file_names[pid], currentProcess->program_counter, currentProcess);
-                currentProcess->program_counter++;
-
-                // Log clock
-                char log_msg[64];
-                sprintf(log_msg, "Clock cycle: %d Completed", clock_cycle);
-                append_log(log_msg);
-
-                // Advance clock
-                clock_cycle++;
-                quantum_used++;
-
-                if (currentProcess->state == BLOCKED)
-                    break;
-            }
+// True while at least one loaded process has not finished
+bool engineHasUnfinished(void) {
+    if (sim->replay)
+        return !sim->replay_done;
+    return sim->finished_count < sim->process_count;
+}
 
-            if (currentProcess->state == BLOCKED) {
-                continue;
-            }
+// Advance the simulation by one clock cycle with the selected policy
+void engineStep(void) {
+    if (schedulerFor(sim->current_algorithm) == NULL) {
+        engineLog("No such scheduling algorithm");
+        return;
+    }
+    if (sim->replay && !replayPending())
+        return;
+    if (sim->trace)
+        traceConfig();
+    if (sim->snapshot_interval > 0 && !sim->replay)
+        snapshotIfDue();
+    switchScheduler();
+    dispatchCycle();
+    sim->step_count++;
+
+    char log_message[64];
+    sprintf(log_message, "Clock cycle %d completed", sim->clock_cycle-1);
+    engineLog(log_message);
+    engineNotifyUpdate();
+}
 
-            if (currentProcess->program_counter >= total_instructions[pid]) {
-                currentProcess->state = FINISHED;
-                finished_processes++;
-            } else {
-                currentProcess->state = READY;
-                if (currentProcess->shiftDown) {
-                    currentProcess->shiftDown = false;
-                    currentProcess->currentMLFQueue = nextQueueLevel;
-                }
-                switch (currentProcess->currentMLFQueue) {
-                    case 1: enqueuePCB(&firstLevelQueue, *currentProcess); break;
-                    case 2: enqueuePCB(&secondLevelQueue, *currentProcess); break;
-                    case 3: enqueuePCB(&thirdLevelQueue, *currentProcess); break;
-                    default: enqueuePCB(&readyQueue, *currentProcess); break;
-                }
-            }
-        } else {
-            append_log("No current Processes to run yet.");
-            clock_cycle++;
-            idleCount++;
+// Step until every process has finished
+void engineRun(void) {
+    while (engineHasUnfinished())
+        engineStep();
+}
+
+// Slowdown of a finished process: turnaround time over the cycles it needed
+static double slowdown(const PCB* p) {
+    int service = p->instruction_count > 0 ? p->instruction_count : 1;
+    return (double)(p->finish_time - p->arrival_time) / service;
+}
+
+// Jain's fairness index over the slowdown of every finished process:
+// 1.0 when all were stretched equally, approaching 1/n when one process
+// absorbed all the waiting
+double engineFairnessIndex(void) {
+    double sum = 0, sum_sq = 0;
+    int n = 0;
+    for (int i = 0; i < sim->process_count; i++) {
+        if (sim->processes[i].state != FINISHED)
+            continue;
+        double s = slowdown(&sim->processes[i]);
+        sum += s;
+        sum_sq += s * s;
+        n++;
+    }
+    return n == 0 || sum_sq == 0 ? 1.0 : (sum * sum) / (n * sum_sq);
+}
+
+double engineMaxSlowdown(void) {
+    double max = 0;
+    for (int i = 0; i < sim->process_count; i++) {
+        if (sim->processes[i].state == FINISHED && slowdown(&sim->processes[i]) > max)
+            max = slowdown(&sim->processes[i]);
+    }
+    return max;
+}
+
+// Start recording this simulation to a trace file; only possible before the
+// first process is loaded
+bool engineStartTrace(const char* path) {
+    if (sim->trace || sim->replay || sim->clock_cycle > 0 || sim->process_count > 0)
+        return false;
+    sim->trace = traceWriterOpen(path);
+    sim->trace_config_count = 0;
+    return sim->trace != NULL;
+}
+
+// Finish the trace file; false if nothing was recording or a write failed
+bool engineStopTrace(void) {
+    if (sim->trace == NULL)
+        return false;
+    bool ok = traceWriterClose(sim->trace, sim->clock_cycle);
+    sim->trace = NULL;
+    return ok;
+}
+
+// Reset the simulation and rebuild it from a trace file; engineStep() then
+// replays one recorded cycle at a time
+bool engineStartReplay(const char* path) {
+    TraceReader* reader = traceReaderOpen(path);
+    if (reader == NULL)
+        return false;
+    engineReset();
+    sim->replay = reader;
+    sim->replay_done = false;
+    return true;
+}
+
+void engineStopReplay(void) {
+    traceReaderClose(sim->replay);
+    sim->replay = NULL;
+}
+
+// Keep a snapshot every `interval` cycles (0 turns snapshots off and drops
+// them) and at most about `limit` of them (0 = SNAPSHOT_DEFAULT_LIMIT)
+bool engineSetSnapshots(int interval, int limit) {
+    if (interval < 0 || limit < 0 || limit == 1)
+        return false;
+    if (interval == 0) {
+        dropSnapshots(0);
+        sim->input_count = 0;
+        sim->input_cursor = 0;
+    }
+    sim->snapshot_interval = interval;
+    sim->snapshot_period = interval;
+    sim->snapshot_limit = limit > 0 ? limit : SNAPSHOT_DEFAULT_LIMIT;
+    return true;
+}
+
+// Return to the state before the last engineStep(); false without an
+// earlier snapshot or while replaying
+bool engineStepBack(void) {
+    if (sim->step_count == 0 || !rewindTo(sim->clock_cycle, sim->step_count - 1))
+        return false;
+    char log_msg[64];
+    sprintf(log_msg, "Stepped back to cycle %d", sim->clock_cycle);
+    engineLog(log_msg);
+    engineNotifyUpdate();
+    return true;
+}
+
+// Return to the start of an earlier clock cycle. With fast-forward on, a
+// cycle inside a skipped idle stretch lands at the end of the stretch.
+bool engineRestoreCycle(int cycle) {
+    if (cycle < 0 || cycle > sim->clock_cycle || !rewindTo(cycle, sim->step_count))
+        return false;
+    char log_msg[64];
+    sprintf(log_msg, "Restored cycle %d", sim->clock_cycle);
+    engineLog(log_msg);
+    engineNotifyUpdate();
+    return true;
+}
+
+// Where "assign x input" gets its values; by default the front end is asked
+void engineUseInputClient(void) {
+    inputFree(&sim->input);
+}
+
+// Values file (see inputLoadFile()); false if it cannot be read, keeping the
+// previous source
+bool engineSetInputFile(const char* path) {
+    return inputLoadFile(&sim->input, path);
+}
+
+// Integers in [min, max] that depend only on the seed, the PID and how many
+// values the process has read, so every algorithm sees the same input
+void engineSetInputGenerator(unsigned seed, int min, int max) {
+    inputUseGenerator(&sim->input, seed, min, max);
+}
+
+// One line per value; the stream stays open and belongs to the caller
+void engineSetInputStream(FILE* stream) {
+    inputUseStream(&sim->input, stream);
+}
+
+// Where "print" and "printFromTo" output goes; by default the front end gets it
+void engineUseOutputClient(void) {
+    outputFree(&sim->output);
+}
+
+// Keep the last `bytes` of output of every process (0 = OUTPUT_RING_DEFAULT);
+// see outputRingRead()
+void engineSetOutputRing(int bytes) {
+    outputUseRing(&sim->output, bytes);
+}
+
+// Buffered file of every output; false if it cannot be created
+bool engineSetOutputFile(const char* path) {
+    OutputSink sink = { 0 };
+    if (!outputOpenFile(&sink, path))
+        return false;
+    outputFree(&sim->output);
+    sim->output = sink;
+    return true;
+}
+
+// The stream stays open and belongs to the caller
+void engineSetOutputStream(FILE* stream) {
+    outputUseStream(&sim->output, stream);
+}
+
+bool engineFlushOutput(void) {
+    return outputFlush(&sim->output);
+}
+
+// Change the number of simulated cores; only possible before the first cycle
+bool engineSetCpuCount(int count) {
+    if (count < 1 || count > MAX_CPUS || sim->clock_cycle > 0)
+        return false;
+    sim->cpu_count = count;
+    engineMarkChanged(CHANGED_QUEUES);
+    return true;
+}
+
+// Latency 0 makes file instructions complete while they execute; otherwise
+// each one blocks its process for `latency` cycles, with up to `depth`
+// requests in service at once. Requests already issued keep their timing.
+bool engineSetDisk(int latency, int depth) {
+    if (latency < 0 || depth < 1)
+        return false;
+    sim->disk_latency = latency;
+    sim->disk_queue_depth = depth;
+    return true;
+}
+
+// Order in which waiting disk requests are served from the next one on
+bool engineSetDiskPolicy(DiskPolicy policy) {
+    if (policy < 0 || policy >= DISK_POLICY_COUNT)
+        return false;
+    sim->disk_policy = policy;
+    return true;
+}
+
+// Read a host file before the run needs it; programs see its content from
+// their first use of `path` on. False if it cannot be read.
+bool engineLoadFile(const char* path) {
+    if (sim->shared_files) {
+        engineLog("Error: Files are shared with another simulation");
+        return false;
+    }
+    return fileSetLoad(&sim->host_files, path, path);
+}
+
+// Start files from another instance's loaded ones instead of this one's. The
+// set must stay unchanged while this instance uses it; NULL goes back to the
+// instance's own files.
+void engineUseFiles(const FileSet* files) {
+    sim->shared_files = files;
+}
+
+const FileSet* engineLoadedFiles(void) {
+    return hostFiles();
+}
+
+// Write every file changed since the last sync to the host; false if any
+// could not be written (it stays changed). Only front ends call this, between
+// steps: the engine never writes files back by itself.
+bool engineSyncFiles(void) {
+    bool ok = true;
+    for (int i = 0; i < sim->files.capacity; i++) {
+        SimFile* f = &sim->files.slots[i];
+        if (f->name == NULL || !f->dirty)
+            continue;
+        FILE* file = fopen(f->name, "w");
+        bool written = file != NULL && fputs(f->content, file) != EOF;
+        if (file != NULL && fclose(file) != 0)
+            written = false;
+        if (!written) {
+            char log_msg[300];
+            snprintf(log_msg, sizeof(log_msg), "Error writing file %s", f->name);
+            engineLog(log_msg);
+            ok = false;
+            continue;
         }
+        f->dirty = false;
+    }
+    return ok;
+}
 
-        if (mode == 2) return; // Step mode
+double engineDiskUtilization(void) {
+    if (sim->clock_cycle == 0)
+        return 0;
+    return (double)sim->disk.busy_cycles / sim->clock_cycle;
+}
+
+double engineIoOverlap(void) {
+    if (sim->disk.busy_cycles == 0)
+        return 0;
+    return (double)sim->disk.overlap_cycles / sim->disk.busy_cycles;
+}
+
+// Fraction of the elapsed cycles a core spent executing instructions
+double engineCoreUtilization(int cpu) {
+    if (cpu < 0 || cpu >= sim->cpu_count || sim->clock_cycle == 0)
+        return 0;
+    return (double)sim->cores[cpu].busy_cycles / sim->clock_cycle;
+}
+
+const char* engineMetricName(Metric metric) {
+    static const char* names[METRIC_COUNT] = {
+        "Turnaround", "Response", "Waiting", "Ready", "Blocked", "I/O wait", "Switches"
+    };
+    return metric >= 0 && metric < METRIC_COUNT ? names[metric] : "Unknown";
+}
+
+const Histogram* engineMetric(Metric metric) {
+    return &sim->metrics[metric];
+}
+
+// Write the counters of every process as CSV; -1 marks what is not known yet
+bool engineWriteMetrics(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+        return false;
+    fprintf(file, "pid,arrival,priority,instructions,first_dispatch,completion,turnaround,"
+                  "response,ready,blocked_userInput,blocked_userOutput,blocked_file,"
+                  "io_wait,context_switches\n");
+    for (int i = 0; i < sim->process_count; i++) {
+        const PCB* p = &sim->processes[i];
+        fprintf(file, "%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\n",
+                p->process_id, p->arrival_time, p->priority, p->instruction_count,
+                p->first_run, p->finish_time,
+                p->finish_time >= 0 ? p->finish_time - p->arrival_time : -1,
+                p->first_run >= 0 ? p->first_run - p->arrival_time : -1,
+                p->ready_cycles, p->blocked_cycles[0], p->blocked_cycles[1],
+                p->blocked_cycles[2], p->io_cycles, p->context_switches);
     }
+    return fclose(file) == 0;
+}
 
-    append_log("All processes completed");
+const char* engineAlgorithmName(SchedulingAlgorithm algorithm) {
+    const SchedulerOps* ops = schedulerFor(algorithm);
+    return ops ? ops->name : "Unknown";
 }
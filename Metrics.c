@@ -0,0 +1,75 @@
+// Metrics.c
+// Log-linear histogram behind the engine's per-run metrics
+#include <string.h>
+#include "Metrics.h"
+
+#define SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+
+// Index of the highest set bit of v (v > 0)
+static int highestBit(unsigned v) {
+    int bit = 0;
+    while (v >>= 1)
+        bit++;
+    return bit;
+}
+
+static int bucketOf(int value) {
+    if (value < HISTOGRAM_EXACT)
+        return value;
+    int bit = highestBit((unsigned)value);
+    int shift = bit - HISTOGRAM_SUB_BITS;
+    return HISTOGRAM_EXACT + (bit - HISTOGRAM_SUB_BITS - 1) * SUB_BUCKETS +
+           ((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+// Smallest value that falls into a bucket, and the number of values it covers
+static int bucketStart(int bucket, int* width) {
+    if (bucket < HISTOGRAM_EXACT) {
+        *width = 1;
+        return bucket;
+    }
+    int group = (bucket - HISTOGRAM_EXACT) / SUB_BUCKETS;
+    int sub = (bucket - HISTOGRAM_EXACT) % SUB_BUCKETS;
+    int shift = group + 1;
+    *width = 1 << shift;
+    return (SUB_BUCKETS + sub) << shift;
+}
+
+void histogramReset(Histogram* h) {
+    memset(h, 0, sizeof(Histogram));
+}
+
+void histogramAdd(Histogram* h, int value) {
+    if (value < 0)
+        value = 0;
+    h->buckets[bucketOf(value)]++;
+    h->count++;
+    h->sum += value;
+    if (value > h->max)
+        h->max = value;
+}
+
+double histogramMean(const Histogram* h) {
+    return h->count > 0 ? (double)h->sum / h->count : 0;
+}
+
+// Middle of the bucket holding the sample of the given rank; exact for small
+// values and never above the largest sample
+int histogramPercentile(const Histogram* h, double percentile) {
+    if (h->count == 0)
+        return 0;
+    long long rank = (long long)(percentile / 100 * h->count + 0.999999);
+    if (rank < 1)
+        rank = 1;
+    long long seen = 0;
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+        seen += h->buckets[b];
+        if (seen >= rank) {
+            int width;
+            int value = bucketStart(b, &width);
+            value += width / 2;
+            return value < h->max ? value : h->max;
+        }
+    }
+    return h->max;
+}
@@ -0,0 +1,25 @@
+// Metrics.h - Streaming summary statistics: count, mean, max and percentiles
+// of integer samples (clock cycles), each sample added in O(1)
+#ifndef METRICS_H
+#define METRICS_H
+
+// Log-linear histogram: values below HISTOGRAM_EXACT get a bucket each, larger
+// ones share 2^HISTOGRAM_SUB_BITS buckets per power of two, so a percentile is
+// off by at most 1/32 of its value
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_EXACT (2 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS (HISTOGRAM_EXACT + (30 - HISTOGRAM_SUB_BITS) * (1 << HISTOGRAM_SUB_BITS))
+
+typedef struct {
+    long long count;
+    long long sum;
+    int max;
+    int buckets[HISTOGRAM_BUCKETS];
+} Histogram;
+
+void histogramReset(Histogram* h);
+void histogramAdd(Histogram* h, int value); // negative values count as 0
+double histogramMean(const Histogram* h);   // 0 when empty
+int histogramPercentile(const Histogram* h, double percentile); // nearest rank, 0 when empty
+
+#endif // METRICS_H
@@ -0,0 +1,188 @@
+// Output.c
+// Program output: text is appended to a growable buffer in O(length) and
+// handed to the sink in chunks, so no output has a size limit
+#include <stdlib.h>
+#include <string.h>
+#include "Output.h"
+#include "Storage.h"
+
+#define OUTPUT_CHUNK (16 * 1024)           // staged bytes before a ring or stream write
+#define OUTPUT_FILE_BUFFER (64 * 1024)
+#define OUTPUT_MAX_TEXT (1 << 30)
+
+bool outputFlush(OutputSink* sink) {
+    if (sink->kind == OUTPUT_STREAM && sink->stream &&
+        (fflush(sink->stream) != 0 || ferror(sink->stream)))
+        sink->failed = true;
+    return !sink->failed;
+}
+
+bool outputFree(OutputSink* sink) {
+    bool ok = outputFlush(sink);
+    if (sink->owns_stream && fclose(sink->stream) != 0)
+        ok = false;
+    free(sink->stream_buffer);
+    for (int i = 0; i < sink->ring_count; i++)
+        free(sink->rings[i].data);
+    free(sink->rings);
+    free(sink->text);
+    memset(sink, 0, sizeof(OutputSink));
+    return ok;
+}
+
+void outputUseRing(OutputSink* sink, int ring_size) {
+    outputFree(sink);
+    sink->kind = OUTPUT_RING;
+    sink->ring_size = ring_size > 0 ? ring_size : OUTPUT_RING_DEFAULT;
+}
+
+bool outputOpenFile(OutputSink* sink, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+        return false;
+    outputUseStream(sink, file);
+    sink->owns_stream = true;
+    sink->stream_buffer = malloc(OUTPUT_FILE_BUFFER);
+    if (sink->stream_buffer)
+        setvbuf(file, sink->stream_buffer, _IOFBF, OUTPUT_FILE_BUFFER);
+    return true;
+}
+
+void outputUseStream(OutputSink* sink, FILE* stream) {
+    outputFree(sink);
+    sink->kind = OUTPUT_STREAM;
+    sink->stream = stream;
+}
+
+void outputClear(OutputSink* sink) {
+    for (int i = 0; i < sink->ring_count; i++)
+        sink->rings[i].written = 0;
+}
+
+// Append to the ring of sink->pid, overwriting its oldest bytes
+static void ringWrite(OutputSink* sink, const char* data, int length) {
+    int index = sink->pid - 1;
+    if (index < 0)
+        return;
+    if (index >= sink->ring_count) {
+        if (!growArray((void**)&sink->rings, &sink->ring_capacity, index + 1,
+                       process_limit, sizeof(OutputRing))) {
+            sink->failed = true;
+            return;
+        }
+        memset(sink->rings + sink->ring_count, 0,
+               (index + 1 - sink->ring_count) * sizeof(OutputRing));
+        sink->ring_count = index + 1;
+    }
+    OutputRing* ring = &sink->rings[index];
+    if (ring->data == NULL && (ring->data = malloc(sink->ring_size)) == NULL) {
+        sink->failed = true;
+        return;
+    }
+    // Only the last ring_size bytes can survive
+    if (length > sink->ring_size) {
+        ring->written += length - sink->ring_size;
+        data += length - sink->ring_size;
+        length = sink->ring_size;
+    }
+    int at = (int)(ring->written % sink->ring_size);
+    int first = sink->ring_size - at < length ? sink->ring_size - at : length;
+    memcpy(ring->data + at, data, first);
+    memcpy(ring->data, data + first, length - first);
+    ring->written += length;
+}
+
+static void emit(OutputSink* sink, const char* data, int length) {
+    if (sink->kind == OUTPUT_RING)
+        ringWrite(sink, data, length);
+    else if (sink->kind == OUTPUT_STREAM &&
+             fwrite(data, 1, length, sink->stream) != (size_t)length)
+        sink->failed = true;
+}
+
+// Hand the staged text to the ring or stream
+static void drain(OutputSink* sink) {
+    emit(sink, sink->text, sink->length);
+    sink->length = 0;
+}
+
+void outputBegin(OutputSink* sink, int pid) {
+    sink->length = 0;
+    sink->pid = pid;
+    sink->last = '\n';
+    if (sink->kind == OUTPUT_STREAM)
+        fprintf(sink->stream, "Process %d output:\n", pid);
+}
+
+void outputWrite(OutputSink* sink, const char* data, int length) {
+    if (length <= 0)
+        return;
+    if (sink->kind != OUTPUT_CLIENT && sink->length + length > OUTPUT_CHUNK)
+        drain(sink);
+    if (sink->kind != OUTPUT_CLIENT && length > OUTPUT_CHUNK) {
+        emit(sink, data, length); // too big to stage
+    } else if (growArray((void**)&sink->text, &sink->capacity, sink->length + length + 1,
+                         OUTPUT_MAX_TEXT, 1)) {
+        memcpy(sink->text + sink->length, data, length);
+        sink->length += length;
+    } else {
+        sink->failed = true;
+        return;
+    }
+    sink->last = data[length - 1];
+}
+
+void outputWriteInt(OutputSink* sink, long long value) {
+    char digits[24];
+    int n = sizeof(digits);
+    unsigned long long v = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[--n] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (value < 0)
+        digits[--n] = '-';
+    outputWrite(sink, digits + n, (int)sizeof(digits) - n);
+}
+
+const char* outputEnd(OutputSink* sink) {
+    switch (sink->kind) {
+    case OUTPUT_CLIENT:
+        if (!growArray((void**)&sink->text, &sink->capacity, sink->length + 1, OUTPUT_MAX_TEXT, 1))
+            return NULL;
+        sink->text[sink->length] = '\0';
+        return sink->text;
+    case OUTPUT_RING:
+        // Every output ends on a line of its own
+        if (sink->last != '\n')
+            outputWrite(sink, "\n", 1);
+        drain(sink);
+        return NULL;
+    default:
+        outputWrite(sink, "\n", 1);
+        drain(sink);
+        return NULL;
+    }
+}
+
+int outputRingRead(const OutputSink* sink, int pid, char* out, int out_size) {
+    if (out_size <= 0)
+        return 0;
+    out[0] = '\0';
+    if (sink->kind != OUTPUT_RING || pid < 1 || pid > sink->ring_count)
+        return 0;
+    const OutputRing* ring = &sink->rings[pid - 1];
+    long long held = ring->written < sink->ring_size ? ring->written : sink->ring_size;
+    int count = held < out_size - 1 ? (int)held : out_size - 1;
+    // The newest `count` bytes, oldest first
+    for (int i = 0; i < count; i++)
+        out[i] = ring->data[(ring->written - count + i) % sink->ring_size];
+    out[count] = '\0';
+    return count;
+}
+
+long long outputRingWritten(const OutputSink* sink, int pid) {
+    if (sink->kind != OUTPUT_RING || pid < 1 || pid > sink->ring_count)
+        return 0;
+    return sink->rings[pid - 1].written;
+}
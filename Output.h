@@ -0,0 +1,67 @@
+// Output.h - Where "print" and "printFromTo" output goes: the front end, an
+// in-memory ring per process, or a buffered stream such as stdout or a file
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define OUTPUT_RING_DEFAULT 4096 // bytes kept per process
+
+typedef enum {
+    OUTPUT_CLIENT = 0, // hand the text to the front end (EngineClient.show_output)
+    OUTPUT_RING,       // keep the latest bytes of each process in memory
+    OUTPUT_STREAM      // "Process N output:" header, the text and a blank line
+} OutputKind;
+
+// Latest output of one process; data is allocated on its first write
+typedef struct {
+    char* data;
+    long long written; // bytes ever written; the ring holds the last ring_size
+} OutputRing;
+
+// A zeroed OutputSink hands the text to the front end
+typedef struct {
+    OutputKind kind;
+
+    // Text of the output being written (outputBegin .. outputEnd). Only the
+    // front end needs it whole; the other sinks take it in chunks.
+    char* text;
+    int length;
+    int capacity;
+    int pid;
+    char last;           // last byte written by the current output
+    bool failed;         // out of memory or a stream write failed
+
+    // OUTPUT_RING: rings[pid - 1]
+    OutputRing* rings;
+    int ring_count;
+    int ring_capacity;
+    int ring_size;
+
+    // OUTPUT_STREAM
+    FILE* stream;
+    bool owns_stream;    // opened by outputOpenFile(), closed by outputFree()
+    char* stream_buffer;
+} OutputSink;
+
+void outputUseRing(OutputSink* sink, int ring_size); // 0 = OUTPUT_RING_DEFAULT
+bool outputOpenFile(OutputSink* sink, const char* path);
+void outputUseStream(OutputSink* sink, FILE* stream);
+bool outputFree(OutputSink* sink);  // back to the front end; false if a write failed
+bool outputFlush(OutputSink* sink); // false if a write failed
+void outputClear(OutputSink* sink); // forget the ring contents
+
+// One output of process `pid`: any number of writes, then outputEnd(), which
+// returns the whole text for the front end (NULL for the other sinks)
+void outputBegin(OutputSink* sink, int pid);
+void outputWrite(OutputSink* sink, const char* data, int length);
+void outputWriteInt(OutputSink* sink, long long value);
+const char* outputEnd(OutputSink* sink);
+
+// Copy what the ring of `pid` still holds, oldest first, NUL terminated;
+// returns the number of bytes copied
+int outputRingRead(const OutputSink* sink, int pid, char* out, int out_size);
+long long outputRingWritten(const OutputSink* sink, int pid);
+
+#endif // OUTPUT_H
@@ -1,42 +1,87 @@
 // Queues.c
-// Implements PCBQueue (FIFO) and PCBMinPQ (min-heap priority queue with FIFO tie-breakers)
+// Implements PCBQueue (FIFO), PCBMinPQ (min-heap priority queue with FIFO tie-breakers),
+// ArrivalQueue and RunTree (red-black tree)
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include "Queues.h"
+#include "Storage.h"
 // -----------------------------------------------------------------------------
 // FIFO Queue (Circular Buffer)
 // -----------------------------------------------------------------------------
 
 void initQueue(PCBQueue *q) {
+    q->data = NULL;
+    q->capacity = 0;
     q->head = q->tail = q->size = 0;
 }
 
+void freeQueue(PCBQueue *q) {
+    free(q->data);
+    initQueue(q);
+}
+
+// Deep copy of src into dst, which must not own a buffer; on failure dst is empty
+bool copyQueue(PCBQueue *dst, const PCBQueue *src) {
+    *dst = *src;
+    if (copyArray((void**)&dst->data, src->data, src->capacity, sizeof(int)))
+        return true;
+    initQueue(dst);
+    return false;
+}
+
 bool isQueueEmpty(const PCBQueue *q) {
     return q->size == 0;
 }
 
+// Full only once the queue holds process_limit entries
 bool isQueueFull(const PCBQueue *q) {
-    return q->size == QUEUE_CAPACITY;
+    return q->size >= process_limit;
+}
+
+// Double the ring buffer, unwrapping it so the front lands at slot 0
+static bool growQueue(PCBQueue *q) {
+    int old_capacity = q->capacity;
+    if (!growArray((void**)&q->data, &q->capacity, q->size + 1, process_limit, sizeof(int)))
+        return false;
+    if (q->size > 0 && q->head >= q->tail) {
+        // The wrapped part [0, tail) now continues after the old end
+        int wrapped = q->tail;
+        for (int i = 0; i < wrapped; i++)
+            q->data[(old_capacity + i) % q->capacity] = q->data[i];
+        q->tail = (old_capacity + wrapped) % q->capacity;
+    }
+    return true;
 }
 
-bool enqueuePCB(PCBQueue *q, PCB pcb) {
+bool enqueuePCB(PCBQueue *q, int index) {
     if (isQueueFull(q))
         return false;
-    q->data[q->tail] = pcb;
-    q->tail = (q->tail + 1) % QUEUE_CAPACITY;
+    if (q->size == q->capacity && !growQueue(q))
+        return false;
+    q->data[q->tail] = index;
+    q->tail = (q->tail + 1) % q->capacity;
     q->size++;
     return true;
 }
 
-bool dequeuePCB(PCBQueue *q, PCB *out) {
+bool dequeuePCB(PCBQueue *q, int *out) {
     if (isQueueEmpty(q))
         return false;
     *out = q->data[q->head];
-    q->head = (q->head + 1) % QUEUE_CAPACITY;
+    q->head = (q->head + 1) % q->capacity;
     q->size--;
     return true;
 }
+
+// Look at the front entry without removing it
+bool peekPCB(const PCBQueue *q, int *out) {
+    if (isQueueEmpty(q))
+        return false;
+    *out = q->data[q->head];
+    return true;
+}
 void printQueue(PCBQueue *q) {
     if (isQueueEmpty(q)) {
         printf("Queue is empty\n");
@@ -44,75 +89,119 @@ void printQueue(PCBQueue *q) {
     }
     printf("Queue contents:\n");
     for (int i = 0; i < q->size; i++) {
-        PCB pcb = q->data[(q->head + i) % QUEUE_CAPACITY];
-        printf("Process ID: %d, State: %d, Priority: %d\n", pcb.process_id, pcb.state, pcb.priority);
+        printf("Process ID: %d\n", queueAt(q, i) + 1);
     }
 }
-void previewQueue(const PCBQueue *q, int outArr[]) {
-    for (int i = 0; i < q->size; i++) {
-        outArr[i] = q->data[(q->head + i) % QUEUE_CAPACITY].process_id;
-    }
+// Process index at position i from the front (0 = next to dequeue)
+int queueAt(const PCBQueue *q, int i) {
+    return q->data[(q->head + i) % q->capacity];
 }
 
 // -----------------------------------------------------------------------------
 // Min-Heap Priority Queue with FIFO tie-breaking
 // -----------------------------------------------------------------------------
 
-// Note: The PCBMinPQ struct (in Structures.h) must be extended as follows:
-//   typedef struct {
-//       PCB      heap[HEAP_CAPACITY];
-//       int      size;
-//       unsigned long seq_counter;            // next sequence number
-//       unsigned long seqs[HEAP_CAPACITY];    // insertion sequence per entry
-//   } PCBMinPQ;
+// Entries are process indices; pos[] maps a process index back to its heap
+// slot so a waiting process can be removed or reprioritized in O(log n).
 
 void initMinPQ(PCBMinPQ *pq) {
+    pq->heap = NULL;
+    pq->keys = NULL;
+    pq->seqs = NULL;
+    pq->capacity = 0;
+    pq->pos = NULL;
+    pq->pos_capacity = 0;
     pq->size = 0;
     pq->seq_counter = 0;
 }
 
+void freeMinPQ(PCBMinPQ *pq) {
+    free(pq->heap);
+    free(pq->keys);
+    free(pq->seqs);
+    free(pq->pos);
+    initMinPQ(pq);
+}
+
+bool copyMinPQ(PCBMinPQ *dst, const PCBMinPQ *src) {
+    *dst = *src;
+    dst->heap = dst->keys = dst->pos = NULL;
+    dst->seqs = NULL;
+    if (copyArray((void**)&dst->heap, src->heap, src->capacity, sizeof(int)) &&
+        copyArray((void**)&dst->keys, src->keys, src->capacity, sizeof(int)) &&
+        copyArray((void**)&dst->seqs, src->seqs, src->capacity, sizeof(unsigned long)) &&
+        copyArray((void**)&dst->pos, src->pos, src->pos_capacity, sizeof(int)))
+        return true;
+    freeMinPQ(dst);
+    return false;
+}
+
 bool isMinPQEmpty(const PCBMinPQ *pq) {
     return pq->size == 0;
 }
 
 bool isMinPQFull(const PCBMinPQ *pq) {
-    return pq->size == HEAP_CAPACITY;
+    return pq->size >= process_limit;
 }
 
-// Swap both PCB and its sequence number
+// Grow the heap arrays together so they always share one capacity
+static bool growHeap(PCBMinPQ *pq) {
+    int cap = pq->capacity;
+    int keys_cap = cap, seqs_cap = cap;
+    if (!growArray((void**)&pq->heap, &cap, pq->size + 1, process_limit, sizeof(int)))
+        return false;
+    if (!growArray((void**)&pq->keys, &keys_cap, cap, process_limit, sizeof(int)))
+        return false;
+    if (!growArray((void**)&pq->seqs, &seqs_cap, cap, process_limit, sizeof(unsigned long)))
+        return false;
+    pq->capacity = cap;
+    return true;
+}
+
+// Make pos[] cover process index `index`, marking new entries as absent
+static bool growPositions(PCBMinPQ *pq, int index) {
+    int old = pq->pos_capacity;
+    if (!growArray((void**)&pq->pos, &pq->pos_capacity, index + 1, process_limit, sizeof(int)))
+        return false;
+    for (int i = old; i < pq->pos_capacity; i++)
+        pq->pos[i] = -1;
+    return true;
+}
+
+// Slot i orders before slot j: lower priority value, then older insertion
+static bool entryBefore(const PCBMinPQ *pq, int i, int j) {
+    if (pq->keys[i] != pq->keys[j])
+        return pq->keys[i] < pq->keys[j];
+    return pq->seqs[i] < pq->seqs[j];
+}
+
+// Swap two slots and keep the position index in sync
 static void swapEntry(PCBMinPQ *pq, int i, int j) {
-    PCB           tmp_pcb  = pq->heap[i];
+    int           tmp_idx  = pq->heap[i];
+    int           tmp_key  = pq->keys[i];
     unsigned long tmp_seq  = pq->seqs[i];
 
     pq->heap[i]   = pq->heap[j];
+    pq->keys[i]   = pq->keys[j];
     pq->seqs[i]   = pq->seqs[j];
 
-    pq->heap[j]   = tmp_pcb;
+    pq->heap[j]   = tmp_idx;
+    pq->keys[j]   = tmp_key;
     pq->seqs[j]   = tmp_seq;
-}
 
-// Bubble-up insertion with tie-break on insertion order
-bool minPQInsert(PCBMinPQ *pq, PCB *pcb) {
-    if (isMinPQFull(pq))
-        return false;
-
-    int idx = pq->size++;
-    pq->heap[idx] = *pcb;
-    pq->seqs[idx] = pq->seq_counter++;
+    pq->pos[pq->heap[i]] = i;
+    pq->pos[pq->heap[j]] = j;
+}
 
+// Bubble-up with tie-break on insertion order
+static void siftUp(PCBMinPQ *pq, int idx) {
     while (idx > 0) {
         int parent = (idx - 1) / 2;
-        bool higherPri = pq->heap[parent].priority > pq->heap[idx].priority;
-        bool tieButOlder = (
-            pq->heap[parent].priority == pq->heap[idx].priority &&
-            pq->seqs[parent] > pq->seqs[idx]
-        );
-        if (!(higherPri || tieButOlder))
+        if (!entryBefore(pq, idx, parent))
             break;
         swapEntry(pq, parent, idx);
         idx = parent;
     }
-    return true;
 }
 
 // Trickle-down (heapify) with FIFO tie-break
@@ -122,24 +211,10 @@ static void minHeapify(PCBMinPQ *pq, int idx) {
         int right    = 2*idx + 2;
         int smallest = idx;
 
-        if (left < pq->size) {
-            bool leftBetter = pq->heap[left].priority < pq->heap[smallest].priority;
-            bool tieButEarlier = (
-                pq->heap[left].priority == pq->heap[smallest].priority &&
-                pq->seqs[left] < pq->seqs[smallest]
-            );
-            if (leftBetter || tieButEarlier)
-                smallest = left;
-        }
-        if (right < pq->size) {
-            bool rightBetter = pq->heap[right].priority < pq->heap[smallest].priority;
-            bool tieButEarlier = (
-                pq->heap[right].priority == pq->heap[smallest].priority &&
-                pq->seqs[right] < pq->seqs[smallest]
-            );
-            if (rightBetter || tieButEarlier)
-                smallest = right;
-        }
+        if (left < pq->size && entryBefore(pq, left, smallest))
+            smallest = left;
+        if (right < pq->size && entryBefore(pq, right, smallest))
+            smallest = right;
         if (smallest == idx)
             break;
         swapEntry(pq, idx, smallest);
@@ -147,24 +222,546 @@ static void minHeapify(PCBMinPQ *pq, int idx) {
     }
 }
 
-// Pop the PCB with smallest priority (and oldest seq on ties)
-bool minPQPop(PCBMinPQ *pq, PCB *out) {
+bool minPQInsert(PCBMinPQ *pq, int index, int priority) {
+    if (isMinPQFull(pq) || !growPositions(pq, index) || pq->pos[index] != -1)
+        return false;
+    if (pq->size == pq->capacity && !growHeap(pq))
+        return false;
+
+    int idx = pq->size++;
+    pq->heap[idx] = index;
+    pq->keys[idx] = priority;
+    pq->seqs[idx] = pq->seq_counter++;
+    pq->pos[index] = idx;
+    siftUp(pq, idx);
+    return true;
+}
+
+// Detach heap slot idx and restore the heap property around the filler entry
+static void removeSlot(PCBMinPQ *pq, int idx) {
+    pq->pos[pq->heap[idx]] = -1;
+    int last = --pq->size;
+    if (idx == last)
+        return;
+    int moved = pq->heap[last];
+    pq->heap[idx] = moved;
+    pq->keys[idx] = pq->keys[last];
+    pq->seqs[idx] = pq->seqs[last];
+    pq->pos[moved] = idx;
+    siftUp(pq, idx);
+    minHeapify(pq, pq->pos[moved]);
+}
+
+// Pop the process with smallest priority (and oldest seq on ties)
+bool minPQPop(PCBMinPQ *pq, int *out) {
     if (isMinPQEmpty(pq))
         return false;
     *out = pq->heap[0];
-    pq->heap[0]  = pq->heap[--pq->size];
-    pq->seqs[0]  = pq->seqs[pq->size];
-    minHeapify(pq, 0);
+    removeSlot(pq, 0);
+    return true;
+}
+
+bool minPQContains(const PCBMinPQ *pq, int index) {
+    return index < pq->pos_capacity && pq->pos[index] != -1;
+}
+
+// Take a waiting process out of the heap wherever it is
+bool minPQRemove(PCBMinPQ *pq, int index) {
+    if (!minPQContains(pq, index))
+        return false;
+    removeSlot(pq, pq->pos[index]);
+    return true;
+}
+
+// Change the priority of a waiting process; it keeps its FIFO sequence number
+bool minPQUpdate(PCBMinPQ *pq, int index, int priority) {
+    if (!minPQContains(pq, index))
+        return false;
+    int idx = pq->pos[index];
+    int old = pq->keys[idx];
+    pq->keys[idx] = priority;
+    if (priority < old)
+        siftUp(pq, idx);
+    else
+        minHeapify(pq, idx);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Ordered iteration: best-first walk of the heap tree. The frontier holds the
+// slots whose parents were already returned, so listing k entries costs
+// O(k log k) and never copies or pops the heap itself.
+// -----------------------------------------------------------------------------
+
+static void frontierPush(MinPQIterator *it, int slot) {
+    int i = it->count++;
+    it->frontier[i] = slot;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!entryBefore(it->pq, it->frontier[i], it->frontier[parent]))
+            break;
+        int tmp = it->frontier[i];
+        it->frontier[i] = it->frontier[parent];
+        it->frontier[parent] = tmp;
+        i = parent;
+    }
+}
+
+static int frontierPop(MinPQIterator *it) {
+    int top = it->frontier[0];
+    it->frontier[0] = it->frontier[--it->count];
+    int i = 0;
+    while (true) {
+        int left = 2*i + 1, right = 2*i + 2, smallest = i;
+        if (left < it->count && entryBefore(it->pq, it->frontier[left], it->frontier[smallest]))
+            smallest = left;
+        if (right < it->count && entryBefore(it->pq, it->frontier[right], it->frontier[smallest]))
+            smallest = right;
+        if (smallest == i)
+            break;
+        int tmp = it->frontier[i];
+        it->frontier[i] = it->frontier[smallest];
+        it->frontier[smallest] = tmp;
+        i = smallest;
+    }
+    return top;
+}
+
+// The frontier never holds more than size entries; it is released by minPQIterEnd
+void minPQIterBegin(MinPQIterator *it, const PCBMinPQ *pq) {
+    it->pq = pq;
+    it->count = 0;
+    it->frontier = pq->size > 0 ? malloc(sizeof(int) * pq->size) : NULL;
+    if (it->frontier)
+        frontierPush(it, 0);
+}
+
+void minPQIterEnd(MinPQIterator *it) {
+    free(it->frontier);
+    it->frontier = NULL;
+    it->count = 0;
+}
+
+// Next process index in pop order; false once every entry was visited
+bool minPQIterNext(MinPQIterator *it, int *index) {
+    if (it->count == 0)
+        return false;
+    int slot = frontierPop(it);
+    *index = it->pq->heap[slot];
+    if (2*slot + 1 < it->pq->size)
+        frontierPush(it, 2*slot + 1);
+    if (2*slot + 2 < it->pq->size)
+        frontierPush(it, 2*slot + 2);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Arrival Queue: processes ordered by arrival time, so each clock cycle only
+// pops the processes that are due instead of scanning the whole table
+// -----------------------------------------------------------------------------
+
+void initArrivalQueue(ArrivalQueue *aq) {
+    aq->time = NULL;
+    aq->index = NULL;
+    aq->capacity = 0;
+    aq->size = 0;
+}
+
+void freeArrivalQueue(ArrivalQueue *aq) {
+    free(aq->time);
+    free(aq->index);
+    initArrivalQueue(aq);
+}
+
+bool copyArrivalQueue(ArrivalQueue *dst, const ArrivalQueue *src) {
+    *dst = *src;
+    dst->time = dst->index = NULL;
+    if (copyArray((void**)&dst->time, src->time, src->capacity, sizeof(int)) &&
+        copyArray((void**)&dst->index, src->index, src->capacity, sizeof(int)))
+        return true;
+    freeArrivalQueue(dst);
+    return false;
+}
+
+bool isArrivalQueueEmpty(const ArrivalQueue *aq) {
+    return aq->size == 0;
+}
+
+// Entry i comes before entry j (earlier arrival, then lower process index)
+static bool arrivalBefore(const ArrivalQueue *aq, int i, int j) {
+    if (aq->time[i] != aq->time[j])
+        return aq->time[i] < aq->time[j];
+    return aq->index[i] < aq->index[j];
+}
+
+static void swapArrival(ArrivalQueue *aq, int i, int j) {
+    int t = aq->time[i];  aq->time[i] = aq->time[j];   aq->time[j] = t;
+    int x = aq->index[i]; aq->index[i] = aq->index[j]; aq->index[j] = x;
+}
+
+bool arrivalQueueInsert(ArrivalQueue *aq, int time, int index) {
+    if (aq->size == aq->capacity) {
+        int cap = aq->capacity, index_cap = aq->capacity;
+        if (!growArray((void**)&aq->time, &cap, aq->size + 1, process_limit, sizeof(int)))
+            return false;
+        if (!growArray((void**)&aq->index, &index_cap, cap, process_limit, sizeof(int)))
+            return false;
+        aq->capacity = cap;
+    }
+    int idx = aq->size++;
+    aq->time[idx] = time;
+    aq->index[idx] = index;
+    while (idx > 0) {
+        int parent = (idx - 1) / 2;
+        if (!arrivalBefore(aq, idx, parent))
+            break;
+        swapArrival(aq, parent, idx);
+        idx = parent;
+    }
     return true;
 }
-void previewMinPQ(const PCBMinPQ *pq, PCB *outArr, int* idx) {
-    // Make a local copy to avoid destroying the original
-    PCBMinPQ temp = *pq;
-    PCB item;
-    idx = 0;
 
-    // Repeatedly pop from the temp heap in sorted order
-    while (minPQPop(&temp, &item)) {
-        outArr[(*idx)++] = item;
+// Arrival time of the next pending process, or -1 if none is left
+int arrivalQueueNextTime(const ArrivalQueue *aq) {
+    return aq->size == 0 ? -1 : aq->time[0];
+}
+
+// Pop the next process whose arrival time is <= now
+bool arrivalQueuePopDue(ArrivalQueue *aq, int now, int *index) {
+    if (aq->size == 0 || aq->time[0] > now)
+        return false;
+    *index = aq->index[0];
+    aq->size--;
+    aq->time[0] = aq->time[aq->size];
+    aq->index[0] = aq->index[aq->size];
+
+    int idx = 0;
+    while (true) {
+        int left = 2*idx + 1;
+        int right = 2*idx + 2;
+        int smallest = idx;
+        if (left < aq->size && arrivalBefore(aq, left, smallest))
+            smallest = left;
+        if (right < aq->size && arrivalBefore(aq, right, smallest))
+            smallest = right;
+        if (smallest == idx)
+            break;
+        swapArrival(aq, idx, smallest);
+        idx = smallest;
     }
-}
\ No newline at end of file
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Red-Black Run Tree: process indices ordered by key, FIFO among equal keys.
+// Nodes live in one array indexed by process index + 1 and slot 0 is a shared
+// black nil leaf, so the tree never allocates per insert. The leftmost node
+// is cached so peeking at the minimum is O(1); insert and remove are O(log n).
+// -----------------------------------------------------------------------------
+
+#define RB_NIL 0
+
+void initRunTree(RunTree *t) {
+    t->nodes = NULL;
+    t->capacity = 0;
+    t->root = RB_NIL;
+    t->leftmost = RB_NIL;
+    t->size = 0;
+    t->seq_counter = 0;
+}
+
+void freeRunTree(RunTree *t) {
+    free(t->nodes);
+    initRunTree(t);
+}
+
+bool copyRunTree(RunTree *dst, const RunTree *src) {
+    *dst = *src;
+    if (copyArray((void**)&dst->nodes, src->nodes, src->capacity, sizeof(RunTreeNode)))
+        return true;
+    initRunTree(dst);
+    return false;
+}
+
+bool isRunTreeEmpty(const RunTree *t) {
+    return t->size == 0;
+}
+
+// Make the node array cover process index `index`; new slots start unlinked
+static bool growRunTree(RunTree *t, int index) {
+    int old = t->capacity;
+    if (!growArray((void**)&t->nodes, &t->capacity, index + 2, process_limit + 1, sizeof(RunTreeNode)))
+        return false;
+    memset(&t->nodes[old], 0, (t->capacity - old) * sizeof(RunTreeNode));
+    return true;
+}
+
+// Slot a orders before slot b: smaller key, then older insertion
+static bool nodeBefore(const RunTree *t, int a, int b) {
+    if (t->nodes[a].key != t->nodes[b].key)
+        return t->nodes[a].key < t->nodes[b].key;
+    return t->nodes[a].seq < t->nodes[b].seq;
+}
+
+static int subtreeMin(const RunTree *t, int x) {
+    while (t->nodes[x].left != RB_NIL)
+        x = t->nodes[x].left;
+    return x;
+}
+
+static int successor(const RunTree *t, int x) {
+    if (t->nodes[x].right != RB_NIL)
+        return subtreeMin(t, t->nodes[x].right);
+    int y = t->nodes[x].parent;
+    while (y != RB_NIL && x == t->nodes[y].right) {
+        x = y;
+        y = t->nodes[y].parent;
+    }
+    return y;
+}
+
+// Put v where u hangs from its parent
+static void replaceChild(RunTree *t, int u, int v) {
+    RunTreeNode *n = t->nodes;
+    int p = n[u].parent;
+    if (p == RB_NIL)
+        t->root = v;
+    else if (u == n[p].left)
+        n[p].left = v;
+    else
+        n[p].right = v;
+    n[v].parent = p; // may write to nil; the delete fixup relies on it
+}
+
+static void rotateLeft(RunTree *t, int x) {
+    RunTreeNode *n = t->nodes;
+    int y = n[x].right;
+    n[x].right = n[y].left;
+    if (n[y].left != RB_NIL)
+        n[n[y].left].parent = x;
+    replaceChild(t, x, y);
+    n[y].left = x;
+    n[x].parent = y;
+}
+
+static void rotateRight(RunTree *t, int x) {
+    RunTreeNode *n = t->nodes;
+    int y = n[x].left;
+    n[x].left = n[y].right;
+    if (n[y].right != RB_NIL)
+        n[n[y].right].parent = x;
+    replaceChild(t, x, y);
+    n[y].right = x;
+    n[x].parent = y;
+}
+
+static void insertFixup(RunTree *t, int z) {
+    RunTreeNode *n = t->nodes;
+    while (n[n[z].parent].red) {
+        int p = n[z].parent;
+        int g = n[p].parent;
+        if (p == n[g].left) {
+            int uncle = n[g].right;
+            if (n[uncle].red) {
+                n[p].red = false;
+                n[uncle].red = false;
+                n[g].red = true;
+                z = g;
+            } else {
+                if (z == n[p].right) {
+                    z = p;
+                    rotateLeft(t, z);
+                    p = n[z].parent;
+                }
+                n[p].red = false;
+                n[g].red = true;
+                rotateRight(t, g);
+            }
+        } else {
+            int uncle = n[g].left;
+            if (n[uncle].red) {
+                n[p].red = false;
+                n[uncle].red = false;
+                n[g].red = true;
+                z = g;
+            } else {
+                if (z == n[p].left) {
+                    z = p;
+                    rotateRight(t, z);
+                    p = n[z].parent;
+                }
+                n[p].red = false;
+                n[g].red = true;
+                rotateLeft(t, g);
+            }
+        }
+    }
+    n[t->root].red = false;
+}
+
+bool runTreeInsert(RunTree *t, int index, long long key) {
+    if (index < 0 || index >= process_limit)
+        return false;
+    if (index + 1 >= t->capacity && !growRunTree(t, index))
+        return false;
+    int z = index + 1;
+    RunTreeNode *n = t->nodes;
+    if (n[z].linked)
+        return false;
+
+    n[z].key = key;
+    n[z].seq = t->seq_counter++;
+    n[z].left = n[z].right = RB_NIL;
+    n[z].red = true;
+    n[z].linked = true;
+
+    int parent = RB_NIL;
+    int x = t->root;
+    while (x != RB_NIL) {
+        parent = x;
+        x = nodeBefore(t, z, x) ? n[x].left : n[x].right;
+    }
+    n[z].parent = parent;
+    if (parent == RB_NIL)
+        t->root = z;
+    else if (nodeBefore(t, z, parent))
+        n[parent].left = z;
+    else
+        n[parent].right = z;
+
+    if (t->leftmost == RB_NIL || nodeBefore(t, z, t->leftmost))
+        t->leftmost = z;
+    t->size++;
+    insertFixup(t, z);
+    return true;
+}
+
+static void deleteFixup(RunTree *t, int x) {
+    RunTreeNode *n = t->nodes;
+    while (x != t->root && !n[x].red) {
+        int p = n[x].parent;
+        if (x == n[p].left) {
+            int w = n[p].right;
+            if (n[w].red) {
+                n[w].red = false;
+                n[p].red = true;
+                rotateLeft(t, p);
+                w = n[p].right;
+            }
+            if (!n[n[w].left].red && !n[n[w].right].red) {
+                n[w].red = true;
+                x = p;
+            } else {
+                if (!n[n[w].right].red) {
+                    n[n[w].left].red = false;
+                    n[w].red = true;
+                    rotateRight(t, w);
+                    w = n[p].right;
+                }
+                n[w].red = n[p].red;
+                n[p].red = false;
+                n[n[w].right].red = false;
+                rotateLeft(t, p);
+                x = t->root;
+            }
+        } else {
+            int w = n[p].left;
+            if (n[w].red) {
+                n[w].red = false;
+                n[p].red = true;
+                rotateRight(t, p);
+                w = n[p].left;
+            }
+            if (!n[n[w].right].red && !n[n[w].left].red) {
+                n[w].red = true;
+                x = p;
+            } else {
+                if (!n[n[w].left].red) {
+                    n[n[w].right].red = false;
+                    n[w].red = true;
+                    rotateLeft(t, w);
+                    w = n[p].left;
+                }
+                n[w].red = n[p].red;
+                n[p].red = false;
+                n[n[w].left].red = false;
+                rotateRight(t, p);
+                x = t->root;
+            }
+        }
+    }
+    n[x].red = false;
+}
+
+// Unlink slot z and rebalance
+static void deleteNode(RunTree *t, int z) {
+    RunTreeNode *n = t->nodes;
+    if (z == t->leftmost)
+        t->leftmost = successor(t, z);
+
+    int y = z;
+    bool removed_black = !n[y].red;
+    int x;
+    if (n[z].left == RB_NIL) {
+        x = n[z].right;
+        replaceChild(t, z, n[z].right);
+    } else if (n[z].right == RB_NIL) {
+        x = n[z].left;
+        replaceChild(t, z, n[z].left);
+    } else {
+        y = subtreeMin(t, n[z].right);
+        removed_black = !n[y].red;
+        x = n[y].right;
+        if (n[y].parent == z) {
+            n[x].parent = y;
+        } else {
+            replaceChild(t, y, n[y].right);
+            n[y].right = n[z].right;
+            n[n[y].right].parent = y;
+        }
+        replaceChild(t, z, y);
+        n[y].left = n[z].left;
+        n[n[y].left].parent = y;
+        n[y].red = n[z].red;
+    }
+    if (removed_black)
+        deleteFixup(t, x);
+
+    n[z].linked = false;
+    n[RB_NIL].parent = RB_NIL;
+    n[RB_NIL].red = false;
+    t->size--;
+}
+
+// Pop the process with the smallest key (oldest insertion on ties)
+bool runTreePopMin(RunTree *t, int *out) {
+    if (t->size == 0)
+        return false;
+    int z = t->leftmost;
+    *out = z - 1;
+    deleteNode(t, z);
+    return true;
+}
+
+bool runTreeContains(const RunTree *t, int index) {
+    return index >= 0 && index + 1 < t->capacity && t->nodes[index + 1].linked;
+}
+
+// Take a process out of the tree wherever it is
+bool runTreeRemove(RunTree *t, int index) {
+    if (!runTreeContains(t, index))
+        return false;
+    deleteNode(t, index + 1);
+    return true;
+}
+
+// In-order walk: first process index, then runTreeNext until -1
+int runTreeFirst(const RunTree *t) {
+    return t->size == 0 ? -1 : t->leftmost - 1;
+}
+
+int runTreeNext(const RunTree *t, int index) {
+    if (!runTreeContains(t, index))
+        return -1;
+    return successor(t, index + 1) - 1;
+}
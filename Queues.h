@@ -9,20 +9,56 @@
 // FIFO Queue (Circular Buffer) Function Declarations
 // -----------------------------------------------------------------------------
 void initQueue(PCBQueue *q);
+void freeQueue(PCBQueue *q);
+bool copyQueue(PCBQueue *dst, const PCBQueue *src);
 bool isQueueEmpty(const PCBQueue *q);
 bool isQueueFull(const PCBQueue *q);
-bool enqueuePCB(PCBQueue *q, PCB pcb);
-bool dequeuePCB(PCBQueue *q, PCB *out);
+bool enqueuePCB(PCBQueue *q, int index);
+bool dequeuePCB(PCBQueue *q, int *out);
+bool peekPCB(const PCBQueue *q, int *out);
 void printQueue(PCBQueue *q);
-void previewQueue(const PCBQueue *q, int outArr[]);
+int  queueAt(const PCBQueue *q, int i);
 
 // -----------------------------------------------------------------------------
 // Min-Heap Priority Queue Function Declarations
 // -----------------------------------------------------------------------------
 void initMinPQ(PCBMinPQ *pq);
+void freeMinPQ(PCBMinPQ *pq);
+bool copyMinPQ(PCBMinPQ *dst, const PCBMinPQ *src);
 bool isMinPQEmpty(const PCBMinPQ *pq);
 bool isMinPQFull(const PCBMinPQ *pq);
-bool minPQInsert(PCBMinPQ *pq, PCB *pcb);
-bool minPQPop(PCBMinPQ *pq, PCB *out);
+bool minPQInsert(PCBMinPQ *pq, int index, int priority);
+bool minPQPop(PCBMinPQ *pq, int *out);
+bool minPQContains(const PCBMinPQ *pq, int index);
+bool minPQRemove(PCBMinPQ *pq, int index);
+bool minPQUpdate(PCBMinPQ *pq, int index, int priority);
+void minPQIterBegin(MinPQIterator *it, const PCBMinPQ *pq);
+bool minPQIterNext(MinPQIterator *it, int *index);
+void minPQIterEnd(MinPQIterator *it);
+
+// -----------------------------------------------------------------------------
+// Arrival Queue (min-heap on arrival time) Function Declarations
+// -----------------------------------------------------------------------------
+void initArrivalQueue(ArrivalQueue *aq);
+void freeArrivalQueue(ArrivalQueue *aq);
+bool copyArrivalQueue(ArrivalQueue *dst, const ArrivalQueue *src);
+bool isArrivalQueueEmpty(const ArrivalQueue *aq);
+bool arrivalQueueInsert(ArrivalQueue *aq, int time, int index);
+int  arrivalQueueNextTime(const ArrivalQueue *aq);
+bool arrivalQueuePopDue(ArrivalQueue *aq, int now, int *index);
+
+// -----------------------------------------------------------------------------
+// Red-Black Run Tree Function Declarations
+// -----------------------------------------------------------------------------
+void initRunTree(RunTree *t);
+void freeRunTree(RunTree *t);
+bool copyRunTree(RunTree *dst, const RunTree *src);
+bool isRunTreeEmpty(const RunTree *t);
+bool runTreeInsert(RunTree *t, int index, long long key);
+bool runTreePopMin(RunTree *t, int *out);
+bool runTreeContains(const RunTree *t, int index);
+bool runTreeRemove(RunTree *t, int index);
+int  runTreeFirst(const RunTree *t);
+int  runTreeNext(const RunTree *t, int index);
 
 #endif // QUEUES_H
\ No newline at end of file
@@ -0,0 +1,370 @@
+// Schedulers.c - Scheduling policies plugged into the engine's dispatch loop
+// Each policy only decides who runs next and where a process goes when it
+// leaves a core; MS2.c owns arrivals, execution, blocking and the clock.
+// Every policy keeps one run queue per simulated core, selected by `cpu`, in
+// the current Simulation instance (Engine.h).
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "Engine.h"
+
+// ============================================================================
+// FCFS and Round Robin: one FIFO ready queue per core
+// ============================================================================
+
+static int fifoPick(int cpu, int* slice, int time_slice) {
+    int index;
+    if (!dequeuePCB(&sim->readyQueues[cpu], &index))
+        return -1;
+    *slice = time_slice;
+    return index;
+}
+
+static void fifoMakeReady(int cpu, int index) {
+    makeReady(&sim->readyQueues[cpu], index);
+}
+
+static void fifoIgnore(int cpu, int index) {
+    (void)cpu;
+    (void)index;
+}
+
+static void fifoReset(void) {
+    for (int c = 0; c < MAX_CPUS; c++)
+        freeQueue(&sim->readyQueues[c]);
+}
+
+// FCFS runs a process until it blocks or finishes
+static int fcfsPick(int cpu, int* slice) {
+    return fifoPick(cpu, slice, 0);
+}
+
+static int roundRobinPick(int cpu, int* slice) {
+    return fifoPick(cpu, slice, sim->quantum);
+}
+
+const SchedulerOps fcfsScheduler = {
+    .name = "FCFS",
+    .reset = fifoReset,
+    .pick_next = fcfsPick,
+    .on_arrival = fifoMakeReady,
+    .on_block = fifoIgnore,
+    .on_unblock = fifoMakeReady,
+    .on_quantum_expire = fifoMakeReady,
+    .on_finish = fifoIgnore
+};
+
+const SchedulerOps roundRobinScheduler = {
+    .name = "Round Robin",
+    .reset = fifoReset,
+    .pick_next = roundRobinPick,
+    .on_arrival = fifoMakeReady,
+    .on_block = fifoIgnore,
+    .on_unblock = fifoMakeReady,
+    .on_quantum_expire = fifoMakeReady,
+    .on_finish = fifoIgnore
+};
+
+// ============================================================================
+// Multilevel Feedback Queue: mlfq_level_count FIFO levels, level 1 first.
+// Using up a whole quantum demotes a process one level. A bitmap tracks the
+// non-empty levels, so pick-next is a find-first-set however many levels
+// there are. Every mlfq_boost_interval cycles (0 = never) all processes go
+// back to level 1 so CPU-bound jobs cannot starve.
+// ============================================================================
+
+static int mlfqClampLevel(int level) {
+    if (level < 1) return sim->mlfq_level_count;
+    if (level > sim->mlfq_level_count) return sim->mlfq_level_count;
+    return level;
+}
+
+// Configured quantum, or 1, 2, 4, ... doubling per level up to MLFQ_MAX_QUANTUM
+static int mlfqQuantum(int level) {
+    level = mlfqClampLevel(level);
+    if (sim->mlfq_quanta[level - 1] > 0)
+        return sim->mlfq_quanta[level - 1];
+    return level > 12 ? MLFQ_MAX_QUANTUM : 1 << (level - 1);
+}
+
+static void mlfqEnqueue(int cpu, int index, int level) {
+    level = mlfqClampLevel(level);
+    sim->processes[index].currentMLFQueue = level;
+    makeReady(&sim->mlfqQueues[cpu][level - 1], index);
+    sim->mlfqNonEmpty[cpu] |= (uint64_t)1 << (level - 1);
+}
+
+// Move every queued process on every core up to level 1; running and blocked
+// processes pick the boost up through their epoch when they are queued again
+static void mlfqBoost(void) {
+    for (int c = 0; c < MAX_CPUS; c++) {
+        for (int l = 2; l <= sim->mlfq_level_count; l++) {
+            int index;
+            while (dequeuePCB(&sim->mlfqQueues[c][l - 1], &index)) {
+                sim->processes[index].boost_epoch = sim->mlfqBoostEpoch + 1;
+                mlfqEnqueue(c, index, 1);
+            }
+        }
+        sim->mlfqNonEmpty[c] &= 1;
+    }
+    sim->mlfqBoostEpoch++;
+    engineLog("MLFQ priority boost: all processes moved to level 1");
+}
+
+// Catch up on boosts that happened while the process was off the queues
+static void mlfqApplyBoost(PCB* p) {
+    if (p->boost_epoch != sim->mlfqBoostEpoch) {
+        p->boost_epoch = sim->mlfqBoostEpoch;
+        p->currentMLFQueue = 1;
+        p->shiftDown = false;
+    }
+}
+
+static int mlfqPick(int cpu, int* slice) {
+    if (sim->mlfq_boost_interval > 0) {
+        if (sim->mlfqNextBoost == 0)
+            sim->mlfqNextBoost = sim->clock_cycle + sim->mlfq_boost_interval;
+        if (sim->clock_cycle >= sim->mlfqNextBoost) {
+            mlfqBoost();
+            sim->mlfqNextBoost = sim->clock_cycle + sim->mlfq_boost_interval;
+        }
+    }
+    if (sim->mlfqNonEmpty[cpu] == 0)
+        return -1;
+
+    int level = __builtin_ctzll(sim->mlfqNonEmpty[cpu]) + 1;
+    int index;
+    dequeuePCB(&sim->mlfqQueues[cpu][level - 1], &index);
+    if (isQueueEmpty(&sim->mlfqQueues[cpu][level - 1]))
+        sim->mlfqNonEmpty[cpu] &= ~((uint64_t)1 << (level - 1));
+    sim->processes[index].currentMLFQueue = level;
+    *slice = mlfqQuantum(level);
+    return index;
+}
+
+static void mlfqArrival(int cpu, int index) {
+    sim->processes[index].boost_epoch = sim->mlfqBoostEpoch;
+    mlfqEnqueue(cpu, index, 1);
+}
+
+// Blocking on the last cycle of the quantum still counts as using all of it
+static void mlfqBlock(int cpu, int index) {
+    PCB* p = &sim->processes[index];
+    (void)cpu;
+    if (p->slice_used >= mlfqQuantum(p->currentMLFQueue))
+        p->shiftDown = true;
+}
+
+static void mlfqUnblock(int cpu, int index) {
+    PCB* p = &sim->processes[index];
+    mlfqApplyBoost(p);
+    int level = p->currentMLFQueue;
+    if (p->shiftDown) {
+        p->shiftDown = false;
+        level++;
+    }
+    mlfqEnqueue(cpu, index, level);
+}
+
+// A boost while the process was running outranks the demotion
+static void mlfqQuantumExpire(int cpu, int index) {
+    PCB* p = &sim->processes[index];
+    if (p->boost_epoch != sim->mlfqBoostEpoch) {
+        mlfqApplyBoost(p);
+        mlfqEnqueue(cpu, index, 1);
+    } else {
+        mlfqEnqueue(cpu, index, p->currentMLFQueue + 1);
+    }
+}
+
+static void mlfqFinish(int cpu, int index) {
+    (void)cpu;
+    sim->processes[index].shiftDown = false;
+}
+
+static void mlfqReset(void) {
+    for (int c = 0; c < MAX_CPUS; c++) {
+        for (int l = 0; l < MLFQ_MAX_LEVELS; l++)
+            freeQueue(&sim->mlfqQueues[c][l]);
+        sim->mlfqNonEmpty[c] = 0;
+    }
+    sim->mlfqBoostEpoch = 0;
+    sim->mlfqNextBoost = 0;
+}
+
+// Change the number of levels and their quanta (NULL = defaults). Processes
+// on levels that no longer exist move to the new last level.
+bool mlfqConfigure(int levels, const int* quanta) {
+    if (levels < 1 || levels > MLFQ_MAX_LEVELS)
+        return false;
+    if (quanta) {
+        for (int l = 0; l < levels; l++)
+            if (quanta[l] < 1)
+                return false;
+    }
+    for (int l = 0; l < MLFQ_MAX_LEVELS; l++)
+        sim->mlfq_quanta[l] = quanta && l < levels ? quanta[l] : 0;
+
+    int old_count = sim->mlfq_level_count;
+    sim->mlfq_level_count = levels;
+    for (int c = 0; c < MAX_CPUS; c++) {
+        for (int l = levels + 1; l <= old_count; l++) {
+            int index;
+            while (dequeuePCB(&sim->mlfqQueues[c][l - 1], &index))
+                mlfqEnqueue(c, index, levels);
+            sim->mlfqNonEmpty[c] &= ~((uint64_t)1 << (l - 1));
+        }
+    }
+    return true;
+}
+
+const SchedulerOps mlfqScheduler = {
+    .name = "Multilevel Feedback Queue",
+    .reset = mlfqReset,
+    .pick_next = mlfqPick,
+    .on_arrival = mlfqArrival,
+    .on_block = mlfqBlock,
+    .on_unblock = mlfqUnblock,
+    .on_quantum_expire = mlfqQuantumExpire,
+    .on_finish = mlfqFinish
+};
+
+// ============================================================================
+// Completely Fair Scheduler: runnable processes sit in a red-black tree keyed
+// on virtual runtime, the CPU time they received divided by their weight.
+// The leftmost (least served) process runs next, for a slice proportional to
+// its share of the total runnable weight on that core.
+// ============================================================================
+
+#define CFS_TARGET_LATENCY 12   // cycles in which every runnable process should run once
+#define CFS_MIN_GRANULARITY 1   // shortest slice, in cycles
+#define CFS_NICE_0_WEIGHT 1024
+#define CFS_VRUNTIME_SCALE 1024 // vruntime units per cycle at nice-0 weight
+
+// Linux nice-to-weight table: each priority step is ~10% CPU share
+static const int cfsPrioToWeight[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+     9548,  7620,  6100,  4904,  3906,
+     3121,  2501,  1991,  1586,  1277,
+     1024,   820,   655,   526,   423,
+      335,   272,   215,   172,   137,
+      110,    87,    70,    56,    45,
+       36,    29,    23,    18,    15,
+};
+
+// PCB.priority works like a nice value: lower means a larger CPU share
+int cfsWeight(int priority) {
+    if (priority < -20) priority = -20;
+    if (priority > 19) priority = 19;
+    return cfsPrioToWeight[priority + 20];
+}
+
+static void cfsEnqueue(int cpu, int index) {
+    PCB* p = &sim->processes[index];
+    engineMarkProcess(index);
+    engineMarkChanged(CHANGED_QUEUES);
+    if (!runTreeInsert(&sim->cfsRunQueues[cpu], index, p->vruntime)) {
+        char log_msg[96];
+        sprintf(log_msg, "Error: could not queue process %d, out of memory", index + 1);
+        engineLog(log_msg);
+        return;
+    }
+    sim->cfsQueuedWeight[cpu] += cfsWeight(p->priority);
+}
+
+// Charge the cycles just run, scaled down for heavier (higher priority) processes
+static void cfsCharge(int index) {
+    PCB* p = &sim->processes[index];
+    p->vruntime += (long long)p->slice_used * CFS_NICE_0_WEIGHT * CFS_VRUNTIME_SCALE
+                   / cfsWeight(p->priority);
+}
+
+static int cfsPick(int cpu, int* slice) {
+    int index;
+    if (!runTreePopMin(&sim->cfsRunQueues[cpu], &index))
+        return -1;
+    PCB* p = &sim->processes[index];
+    int weight = cfsWeight(p->priority);
+
+    // Share of the latency period proportional to weight, out of everyone runnable
+    long long share = (long long)CFS_TARGET_LATENCY * weight / sim->cfsQueuedWeight[cpu];
+    *slice = share < CFS_MIN_GRANULARITY ? CFS_MIN_GRANULARITY : (int)share;
+
+    sim->cfsQueuedWeight[cpu] -= weight;
+    if (p->vruntime > sim->cfsMinVruntime[cpu])
+        sim->cfsMinVruntime[cpu] = p->vruntime;
+    return index;
+}
+
+// Newcomers start level with the least served process instead of at zero
+static void cfsArrival(int cpu, int index) {
+    PCB* p = &sim->processes[index];
+    if (p->vruntime < sim->cfsMinVruntime[cpu])
+        p->vruntime = sim->cfsMinVruntime[cpu];
+    cfsEnqueue(cpu, index);
+}
+
+static void cfsBlock(int cpu, int index) {
+    (void)cpu;
+    cfsCharge(index);
+}
+
+// Sleepers get at most half a latency period of credit when they wake up
+static void cfsUnblock(int cpu, int index) {
+    PCB* p = &sim->processes[index];
+    long long earliest = sim->cfsMinVruntime[cpu] - (long long)CFS_TARGET_LATENCY * CFS_VRUNTIME_SCALE / 2;
+    if (p->vruntime < earliest)
+        p->vruntime = earliest;
+    cfsEnqueue(cpu, index);
+}
+
+static void cfsQuantumExpire(int cpu, int index) {
+    cfsCharge(index);
+    cfsEnqueue(cpu, index);
+}
+
+// Cores keep separate vruntime clocks: keep a stolen process's lead or lag
+// relative to the min vruntime of the core it moves to
+static void cfsMigrate(int from, int to, int index) {
+    sim->processes[index].vruntime += sim->cfsMinVruntime[to] - sim->cfsMinVruntime[from];
+}
+
+static void cfsFinish(int cpu, int index) {
+    (void)cpu;
+    cfsCharge(index);
+}
+
+static void cfsReset(void) {
+    for (int c = 0; c < MAX_CPUS; c++) {
+        freeRunTree(&sim->cfsRunQueues[c]);
+        sim->cfsMinVruntime[c] = 0;
+        sim->cfsQueuedWeight[c] = 0;
+    }
+}
+
+const SchedulerOps cfsScheduler = {
+    .name = "Completely Fair Scheduler",
+    .reset = cfsReset,
+    .pick_next = cfsPick,
+    .on_arrival = cfsArrival,
+    .on_block = cfsBlock,
+    .on_unblock = cfsUnblock,
+    .on_quantum_expire = cfsQuantumExpire,
+    .on_finish = cfsFinish,
+    .on_migrate = cfsMigrate
+};
+
+// ============================================================================
+// Policy lookup
+// ============================================================================
+
+const SchedulerOps* schedulerFor(SchedulingAlgorithm algorithm) {
+    switch (algorithm) {
+        case FCFS: return &fcfsScheduler;
+        case ROUND_ROBIN: return &roundRobinScheduler;
+        case MULTILEVEL_FEEDBACK: return &mlfqScheduler;
+        case CFS: return &cfsScheduler;
+    }
+    return NULL;
+}
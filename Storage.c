@@ -0,0 +1,181 @@
+// Storage.c
+// Growable arrays for the process table, simulated memory, ready queues and wait heaps,
+// and the per-simulation string arena
+#include <stdlib.h>
+#include <string.h>
+#include "Storage.h"
+#include "sched_structs.h"
+
+#define INITIAL_CAPACITY 16
+
+int process_limit = DEFAULT_PROCESS_LIMIT;
+
+bool growArray(void** data, int* capacity, int needed, int limit, size_t elem_size) {
+    if (needed <= *capacity)
+        return true;
+    if (needed > limit)
+        return false;
+
+    long new_capacity = *capacity > 0 ? *capacity : INITIAL_CAPACITY;
+    while (new_capacity < needed)
+        new_capacity *= 2;
+    if (new_capacity > limit)
+        new_capacity = limit;
+
+    void* grown = realloc(*data, new_capacity * elem_size);
+    if (grown == NULL)
+        return false;
+    *data = grown;
+    *capacity = (int)new_capacity;
+    return true;
+}
+
+bool copyArray(void** copy, const void* data, int count, size_t elem_size) {
+    *copy = NULL;
+    if (count <= 0)
+        return true;
+    *copy = malloc(count * elem_size);
+    if (*copy == NULL)
+        return false;
+    memcpy(*copy, data, count * elem_size);
+    return true;
+}
+
+// ============================================================================
+// String arena
+// ============================================================================
+
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGN 16
+#define INITIAL_INTERN_CAPACITY 256
+
+struct ArenaBlock {
+    ArenaBlock* next;
+    size_t size;
+    size_t used;
+    char data[];
+};
+
+void initArena(Arena* arena) {
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->interned = NULL;
+    arena->intern_capacity = 0;
+    arena->intern_count = 0;
+    arena->generation = 0;
+}
+
+void freeArena(Arena* arena) {
+    ArenaBlock* block = arena->first;
+    while (block) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena->interned);
+    initArena(arena);
+}
+
+// Forget every allocation; the blocks are reused by later allocations
+void arenaReset(Arena* arena) {
+    arena->current = arena->first;
+    if (arena->current)
+        arena->current->used = 0;
+    arena->intern_count = 0;
+    arena->generation++;
+}
+
+void* arenaAlloc(Arena* arena, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    ArenaBlock* block = arena->current;
+    if (block && block->size - block->used >= size) {
+        void* p = block->data + block->used;
+        block->used += size;
+        return p;
+    }
+
+    // Move on to the next block left over from before a reset if it is big enough
+    if (block && block->next && block->next->size >= size) {
+        block = block->next;
+        block->used = 0;
+    } else {
+        size_t block_size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        ArenaBlock* fresh = malloc(sizeof(ArenaBlock) + block_size);
+        if (fresh == NULL)
+            return NULL;
+        fresh->size = block_size;
+        fresh->used = 0;
+        if (block) {
+            fresh->next = block->next;
+            block->next = fresh;
+        } else {
+            fresh->next = arena->first;
+            arena->first = fresh;
+        }
+        block = fresh;
+    }
+    arena->current = block;
+    block->used = size;
+    return block->data;
+}
+
+static unsigned hashString(const char* s) {
+    unsigned h = 2166136261u; // FNV-1a
+    while (*s)
+        h = (h ^ (unsigned char)*s++) * 16777619u;
+    return h;
+}
+
+// Entries from before the last reset count as empty slots
+static bool entryLive(const Arena* arena, const InternEntry* e) {
+    return e->str != NULL && e->generation == arena->generation;
+}
+
+static bool growInternTable(Arena* arena) {
+    int capacity = arena->intern_capacity ? arena->intern_capacity * 2 : INITIAL_INTERN_CAPACITY;
+    InternEntry* table = calloc(capacity, sizeof(InternEntry));
+    if (table == NULL)
+        return false;
+
+    // Rehash live entries only; stale ones from before a reset are dropped
+    for (int i = 0; i < arena->intern_capacity; i++) {
+        InternEntry* e = &arena->interned[i];
+        if (!entryLive(arena, e))
+            continue;
+        int j = e->hash & (capacity - 1);
+        while (table[j].str != NULL)
+            j = (j + 1) & (capacity - 1);
+        table[j] = *e;
+    }
+    free(arena->interned);
+    arena->interned = table;
+    arena->intern_capacity = capacity;
+    return true;
+}
+
+char* arenaIntern(Arena* arena, const char* s) {
+    if ((arena->intern_count + 1) * 2 > arena->intern_capacity && !growInternTable(arena))
+        return NULL;
+
+    unsigned hash = hashString(s);
+    int mask = arena->intern_capacity - 1;
+    int i = hash & mask;
+    while (entryLive(arena, &arena->interned[i])) {
+        if (arena->interned[i].hash == hash && strcmp(arena->interned[i].str, s) == 0)
+            return arena->interned[i].str;
+        i = (i + 1) & mask;
+    }
+
+    size_t len = strlen(s) + 1;
+    char* copy = arenaAlloc(arena, len);
+    if (copy == NULL)
+        return NULL;
+    memcpy(copy, s, len);
+
+    arena->interned[i].str = copy;
+    arena->interned[i].hash = hash;
+    arena->interned[i].generation = arena->generation;
+    arena->intern_count++;
+    return copy;
+}
@@ -0,0 +1,48 @@
+// Storage.h - Growable arrays backing the engine tables, queues and heaps,
+// and the string arena backing simulated memory
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Upper bound on processes, chosen once at startup; every table is sized from it
+extern int process_limit;
+
+// Make room for at least `needed` elements of `elem_size` bytes. Capacity
+// doubles on each growth so appends are amortized O(1); fails (leaving the
+// array untouched) past `limit` elements or when out of memory.
+bool growArray(void** data, int* capacity, int needed, int limit, size_t elem_size);
+
+// Point *copy at a fresh copy of the first `count` elements of `data`
+// (NULL when count is 0); false when out of memory
+bool copyArray(void** copy, const void* data, int count, size_t elem_size);
+
+// Bump allocator for strings owned by one simulation. Blocks are kept across
+// resets and reused, so arenaReset() releases everything in O(1). A zeroed
+// Arena is a valid empty arena.
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct {
+    char* str;
+    unsigned hash;
+    unsigned generation; // entry is live only if it matches Arena.generation
+} InternEntry;
+
+typedef struct {
+    ArenaBlock* first;
+    ArenaBlock* current;     // block allocations are bumped from
+    InternEntry* interned;   // open addressing hash set of interned strings
+    int intern_capacity;     // power of two
+    int intern_count;
+    unsigned generation;     // bumped by arenaReset to drop every entry at once
+} Arena;
+
+void initArena(Arena* arena);
+void freeArena(Arena* arena);
+void arenaReset(Arena* arena);
+void* arenaAlloc(Arena* arena, size_t size);
+// Copy of `s` shared with every other interned string of equal contents; read-only
+char* arenaIntern(Arena* arena, const char* s);
+
+#endif // STORAGE_H
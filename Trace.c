@@ -0,0 +1,259 @@
+// Trace.c
+// Binary trace file: an 8-byte magic and a version, then one record per event:
+//   clock delta, type, int count, ints..., string count, (length, bytes)...
+// Every number is a LEB128 varint; clock deltas and ints are zigzag encoded so
+// small negative values stay short. A dispatch record is typically 6 bytes.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Trace.h"
+#include "Storage.h"
+
+#define TRACE_MAGIC "SIMTRACE"
+#define TRACE_MAGIC_LENGTH 8
+#define TRACE_VERSION 3 // 2: disk settings in TRACE_CONFIG, 3: disk policy and TRACE_DISK
+#define TRACE_BUFFER_SIZE (64 * 1024)
+#define TRACE_MAX_OPERANDS 1024          // per event, ints or strings
+#define TRACE_MAX_TEXT (16 * 1024 * 1024) // string bytes per event
+
+static unsigned zigzagEncode(int v) {
+    return ((unsigned)v << 1) ^ (unsigned)-(v < 0);
+}
+
+static int zigzagDecode(unsigned v) {
+    return (int)(v >> 1) ^ -(int)(v & 1);
+}
+
+// ============================================================================
+// Writer: records go into a fixed buffer that is written out when full
+// ============================================================================
+
+struct TraceWriter {
+    FILE* file;
+    int last_clock;
+    bool failed;
+    int used;
+    unsigned char buffer[TRACE_BUFFER_SIZE];
+};
+
+static void writerFlush(TraceWriter* w) {
+    if (w->used > 0 && fwrite(w->buffer, 1, w->used, w->file) != (size_t)w->used)
+        w->failed = true;
+    w->used = 0;
+}
+
+static void putBytes(TraceWriter* w, const void* data, size_t length) {
+    const unsigned char* bytes = data;
+    while (length > 0) {
+        if (w->used == TRACE_BUFFER_SIZE)
+            writerFlush(w);
+        size_t chunk = TRACE_BUFFER_SIZE - w->used;
+        if (chunk > length)
+            chunk = length;
+        memcpy(w->buffer + w->used, bytes, chunk);
+        w->used += chunk;
+        bytes += chunk;
+        length -= chunk;
+    }
+}
+
+static void putVarint(TraceWriter* w, unsigned v) {
+    unsigned char bytes[5];
+    int n = 0;
+    while (v >= 0x80) {
+        bytes[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    bytes[n++] = (unsigned char)v;
+    putBytes(w, bytes, n);
+}
+
+TraceWriter* traceWriterOpen(const char* path) {
+    TraceWriter* w = malloc(sizeof(TraceWriter));
+    if (w == NULL)
+        return NULL;
+    w->file = fopen(path, "wb");
+    if (w->file == NULL) {
+        free(w);
+        return NULL;
+    }
+    w->last_clock = 0;
+    w->failed = false;
+    w->used = 0;
+    putBytes(w, TRACE_MAGIC, TRACE_MAGIC_LENGTH);
+    putVarint(w, TRACE_VERSION);
+    return w;
+}
+
+bool traceWrite(TraceWriter* w, int clock, TraceEventType type,
+                const int* ints, int int_count,
+                const char* const* strings, int string_count) {
+    putVarint(w, zigzagEncode(clock - w->last_clock));
+    w->last_clock = clock;
+    putVarint(w, type);
+    putVarint(w, int_count);
+    for (int i = 0; i < int_count; i++)
+        putVarint(w, zigzagEncode(ints[i]));
+    putVarint(w, string_count);
+    for (int i = 0; i < string_count; i++) {
+        size_t length = strlen(strings[i]);
+        putVarint(w, (unsigned)length);
+        putBytes(w, strings[i], length);
+    }
+    return !w->failed;
+}
+
+bool traceWriterClose(TraceWriter* w, int clock) {
+    if (w == NULL)
+        return false;
+    traceWrite(w, clock, TRACE_END, NULL, 0, NULL, 0);
+    writerFlush(w);
+    bool ok = !w->failed;
+    if (fclose(w->file) != 0)
+        ok = false;
+    free(w);
+    return ok;
+}
+
+// ============================================================================
+// Reader: decodes one event ahead so the engine can peek at what comes next
+// ============================================================================
+
+struct TraceReader {
+    FILE* file;
+    int clock;
+    bool has_event;     // event holds the next, not yet consumed record
+    bool done;          // end of file or corrupt record reached
+    TraceEvent event;
+    int int_capacity;
+    int string_capacity;
+    int offset_capacity;
+    int* offsets;       // string start offsets into text while decoding
+    char* text;         // bytes of every string of the current event
+    int text_capacity;
+    int pos, length;
+    unsigned char buffer[TRACE_BUFFER_SIZE];
+};
+
+static bool getByte(TraceReader* r, unsigned char* out) {
+    if (r->pos == r->length) {
+        r->length = (int)fread(r->buffer, 1, TRACE_BUFFER_SIZE, r->file);
+        r->pos = 0;
+        if (r->length == 0)
+            return false;
+    }
+    *out = r->buffer[r->pos++];
+    return true;
+}
+
+static bool getVarint(TraceReader* r, unsigned* out) {
+    unsigned v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        unsigned char byte;
+        if (!getByte(r, &byte))
+            return false;
+        v |= (unsigned)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool getBytes(TraceReader* r, char* out, int count) {
+    for (int i = 0; i < count; i++) {
+        unsigned char byte;
+        if (!getByte(r, &byte))
+            return false;
+        out[i] = (char)byte;
+    }
+    return true;
+}
+
+// Decode the next record into r->event; false at the end or on corruption
+static bool readEvent(TraceReader* r) {
+    TraceEvent* e = &r->event;
+    unsigned delta, type, count;
+    if (!getVarint(r, &delta) || !getVarint(r, &type) || type > TRACE_DISK)
+        return false;
+    r->clock += zigzagDecode(delta);
+    e->clock = r->clock;
+    e->type = (TraceEventType)type;
+
+    if (!getVarint(r, &count) || count > TRACE_MAX_OPERANDS ||
+        !growArray((void**)&e->ints, &r->int_capacity, count, TRACE_MAX_OPERANDS, sizeof(int)))
+        return false;
+    e->int_count = count;
+    for (unsigned i = 0; i < count; i++) {
+        unsigned v;
+        if (!getVarint(r, &v))
+            return false;
+        e->ints[i] = zigzagDecode(v);
+    }
+
+    if (!getVarint(r, &count) || count > TRACE_MAX_OPERANDS ||
+        !growArray((void**)&e->strings, &r->string_capacity, count, TRACE_MAX_OPERANDS, sizeof(char*)) ||
+        !growArray((void**)&r->offsets, &r->offset_capacity, count, TRACE_MAX_OPERANDS, sizeof(int)))
+        return false;
+    e->string_count = count;
+    int used = 0;
+    for (unsigned i = 0; i < count; i++) {
+        unsigned length;
+        if (!getVarint(r, &length) || length >= TRACE_MAX_TEXT ||
+            !growArray((void**)&r->text, &r->text_capacity, used + length + 1,
+                       TRACE_MAX_TEXT, 1) ||
+            !getBytes(r, r->text + used, length))
+            return false;
+        r->offsets[i] = used;
+        used += length;
+        r->text[used++] = '\0';
+    }
+    // Pointers only once the text buffer has stopped moving
+    for (unsigned i = 0; i < count; i++)
+        e->strings[i] = r->text + r->offsets[i];
+    return true;
+}
+
+TraceReader* traceReaderOpen(const char* path) {
+    TraceReader* r = calloc(1, sizeof(TraceReader));
+    if (r == NULL)
+        return NULL;
+    r->file = fopen(path, "rb");
+    if (r->file == NULL) {
+        free(r);
+        return NULL;
+    }
+    char magic[TRACE_MAGIC_LENGTH];
+    unsigned version;
+    if (!getBytes(r, magic, TRACE_MAGIC_LENGTH) ||
+        memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_LENGTH) != 0 ||
+        !getVarint(r, &version) || version != TRACE_VERSION) {
+        traceReaderClose(r);
+        return NULL;
+    }
+    return r;
+}
+
+const TraceEvent* tracePeek(TraceReader* r) {
+    if (!r->has_event && !r->done) {
+        r->has_event = readEvent(r);
+        r->done = !r->has_event;
+    }
+    return r->has_event ? &r->event : NULL;
+}
+
+void traceConsume(TraceReader* r) {
+    r->has_event = false;
+}
+
+void traceReaderClose(TraceReader* r) {
+    if (r == NULL)
+        return;
+    fclose(r->file);
+    free(r->event.ints);
+    free(r->event.strings);
+    free(r->offsets);
+    free(r->text);
+    free(r);
+}
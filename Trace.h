@@ -0,0 +1,57 @@
+// Trace.h - Compact binary trace of scheduling events, written through a
+// buffer and read back one event at a time
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+
+// Event kinds. Operands are listed as ints[0], ints[1], ...
+typedef enum {
+    TRACE_END = 0,   // recording stopped
+    TRACE_CONFIG,    // settings from this cycle on: cores, algorithm, quantum,
+                     // fast-forward, boost interval, levels, quanta per level,
+                     // disk latency, queue depth, disk policy
+    TRACE_LOAD,      // new process: arrival, priority; strings = program lines
+    TRACE_ARRIVE,    // process index, core
+    TRACE_DISPATCH,  // process index, core
+    TRACE_PREEMPT,   // process index, core (quantum expired)
+    TRACE_BLOCK,     // process index, resource (3 = a disk request)
+    TRACE_UNBLOCK,   // process index, resource (handed the mutex, or the disk
+                     // request completed)
+    TRACE_FINISH,    // process index, core
+    TRACE_WAIT,      // process index, resource (executed semWait)
+    TRACE_SIGNAL,    // process index, resource (executed semSignal)
+    TRACE_WRITE,     // process index, variable slot; strings[0] = new value
+    TRACE_DISK       // process index, first block, block count (disk request
+                     // issued, followed by its BLOCK event)
+} TraceEventType;
+
+// A decoded event; its arrays belong to the reader and stay valid until the
+// next traceConsume()
+typedef struct {
+    TraceEventType type;
+    int clock;
+    int* ints;
+    int int_count;
+    char** strings;
+    int string_count;
+} TraceEvent;
+
+typedef struct TraceWriter TraceWriter;
+typedef struct TraceReader TraceReader;
+
+// Writing: every event is stored as the clock delta since the previous
+// event, the type and its operands, all as variable-length integers
+TraceWriter* traceWriterOpen(const char* path);
+bool traceWrite(TraceWriter* w, int clock, TraceEventType type,
+                const int* ints, int int_count,
+                const char* const* strings, int string_count);
+bool traceWriterClose(TraceWriter* w, int clock); // appends TRACE_END; false if any write failed
+
+// Reading: NULL from tracePeek() at the end of the file or on a corrupt event
+TraceReader* traceReaderOpen(const char* path);
+const TraceEvent* tracePeek(TraceReader* r);
+void traceConsume(TraceReader* r);
+void traceReaderClose(TraceReader* r);
+
+#endif // TRACE_H
@@ -7,33 +7,42 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "Queues.h"
+#include "Engine.h"
 
 // Global variables
-PCB processes[MAX_PROCESSES];
-int process_count = 0;
-MemoryWord memory[MEMORY_SIZE];
-int clock_cycle = 0;
-SchedulingAlgorithm current_algorithm = FCFS;
-int quantum = 2;
-Resource resources[3]; // userInput, userOutput, file
-int running_process_index = -1;
-int blocked_queue[MAX_PROCESSES];
-int blocked_queue_count = 0;
 gboolean simulation_running = FALSE;
-int mode;
-int filecount;
-char file_names[MAX_PROCESSES][256]; // Change to array of char arrays instead of array of pointers - DONT CHANGE SIZE
-bool step = false;
-int idleCount = 0;
-int blocked_priority[MAX_PROCESSES];
-char * blocked_locations[MAX_PROCESSES];
-
-//imported from backend vars
-PCBQueue firstLevelQueue;
-PCBQueue secondLevelQueue;
-PCBQueue thirdLevelQueue;
-PCBQueue readyQueue; // Also works as fourth queue in MLFQ (Round Robin)
+guint run_source_id = 0;        // idle source driving a continuous run, 0 when none
+guint refresh_source_id = 0;    // pending coalesced redraw, 0 when none
+
+// Longest a continuous-run chunk may hold the main loop (microseconds, ~one frame)
+#define RUN_CHUNK_BUDGET_US 8000
+// Engine updates are coalesced into at most one redraw per interval (~30 Hz)
+#define REFRESH_INTERVAL_MS 33
+
+// Engine settings the GUI starts with
+#define TRACE_FILE_NAME "simulation.trace"
+#define SNAPSHOT_INTERVAL 100   // cycles between snapshots for stepping back
+#define INPUT_SEED 1            // generated input is the same on every run
+#define INPUT_MIN 0
+#define INPUT_MAX 100
+#define OUTPUT_RING_BYTES 16384 // program output kept per process for the output panel
+
+// Log ring: messages are queued with their clock cycle and written to the
+// text view in one batch per refresh; the view keeps the last LOG_MAX_LINES
+#define LOG_RING_SIZE 1024
+#define LOG_LINE_LENGTH 160
+#define LOG_MAX_LINES 5000
+
+typedef struct {
+    int clock;
+    char text[LOG_LINE_LENGTH];
+} LogEntry;
+
+static LogEntry log_ring[LOG_RING_SIZE];
+static int log_head = 0;    // oldest pending message
+static int log_count = 0;   // pending messages
+static int log_dropped = 0; // overwritten before they could be flushed
+
 // GUI Components
 GtkWidget *window;
 GtkWidget *main_box;
@@ -49,15 +58,30 @@ GtkListStore *blocked_queue_store;
 
 GtkWidget *clock_cycle_label;
 GtkWidget *algo_label;
+GtkWidget *turnaround_label;
+GtkWidget *response_label;
 
 // Control Panel Components
 GtkWidget *control_panel_frame;
 GtkWidget *algorithm_combo;
 GtkWidget *quantum_spin;
+GtkWidget *mlfq_levels_spin;
+GtkWidget *mlfq_boost_spin;
+GtkWidget *cpu_count_spin;
+GtkWidget *disk_latency_spin;
+GtkWidget *disk_policy_combo;
 GtkWidget *start_button;
 GtkWidget *stop_button;
 GtkWidget *reset_button;
 GtkWidget *step_button;
+GtkWidget *step_back_button;
+GtkWidget *goto_cycle_spin;
+GtkWidget *goto_cycle_button;
+GtkWidget *fast_forward_check;
+GtkWidget *record_trace_check;
+GtkWidget *replay_chooser_button;
+GtkWidget *input_source_combo;
+GtkWidget *input_chooser_button;
 
 // Resource Panel Components
 GtkWidget *resource_panel_frame;
@@ -75,9 +99,18 @@ GtkWidget *log_frame;
 GtkWidget *log_view;
 GtkTextBuffer *log_buffer;
 
+// Program Output Components
+GtkWidget *output_frame;
+GtkWidget *output_pid_spin;
+GtkWidget *output_view;
+GtkTextBuffer *output_buffer;
+static int output_shown_pid = 0;         // process and byte count on display
+static long long output_shown_written = -1;
+
 // Process Creation Components
 GtkWidget *process_creation_frame;
 GtkWidget *file_chooser_button;
+GtkWidget *data_file_chooser_button;
 GtkWidget *arrival_time_spin;
 GtkWidget *priority_spin;  // Add this line
 GtkWidget *add_process_button;
@@ -89,54 +122,70 @@ void setup_control_panel();
 void setup_resource_panel();
 void setup_memory_viewer();
 void setup_log_console();
+void setup_output_panel();
 void setup_process_creation();
 void update_ui();
+void update_output_panel();
 void append_log(const char* message);
+void flush_log();
+void clear_log();
 void start_simulation();
 void stop_simulation();
 void reset_simulation();
 void step_simulation();
+void step_back_simulation();
+void goto_cycle();
+void sync_settings_widgets();
+void select_input_source();
 void add_process();
 void change_algorithm();
-void initialize_resources();
 void update_blocked_queue();
 void update_ready_queue_table();
 void update_blocked_queue_table();
-void executeInstructionUI(char* line, PCB* process);
-void update_ready_queue_table();
-bool checkFNS();
-
-
-//backend functions
-extern Resource* mutex_converter(char* name);
-extern bool signalMutex(Resource* m);
-extern bool waitMutex(Resource* m, PCB* pcb);
-extern void setVariable(PCB* process, char* name, char* value);
-extern char* getVariable(PCB* process, char* name);
-extern void fileReader(const char* fileName, PCB* process);
-extern int countInstructions(const char *filename);
-extern void executeLineFromFile(const char *filename, int program_counter, PCB *process);
-extern void round_Robin();
-extern void mlfq();
-extern void fcfs();
+bool ui_read_input(PCB* process, const char* variable, char* out, int out_size);
+void ui_on_engine_update();
+gboolean run_simulation_chunk(gpointer data);
 
 // Signal handlers
 void on_start_button_clicked(GtkWidget *widget, gpointer data);
 void on_stop_button_clicked(GtkWidget *widget, gpointer data);
 void on_reset_button_clicked(GtkWidget *widget, gpointer data);
 void on_step_button_clicked(GtkWidget *widget, gpointer data);
+void on_step_back_button_clicked(GtkWidget *widget, gpointer data);
+void on_goto_cycle_clicked(GtkWidget *widget, gpointer data);
 void on_add_process_clicked(GtkWidget *widget, gpointer data);
 void on_algorithm_changed(GtkWidget *widget, gpointer data);
 void on_quantum_changed(GtkWidget *widget, gpointer data);
+void on_mlfq_levels_changed(GtkWidget *widget, gpointer data);
+void on_mlfq_boost_changed(GtkWidget *widget, gpointer data);
+void on_cpu_count_changed(GtkWidget *widget, gpointer data);
+void on_disk_latency_changed(GtkWidget *widget, gpointer data);
+void on_disk_policy_changed(GtkWidget *widget, gpointer data);
+void on_fast_forward_toggled(GtkWidget *widget, gpointer data);
 void on_file_set(GtkWidget *widget, gpointer data);
+void on_data_file_set(GtkWidget *widget, gpointer data);
+void on_record_trace_toggled(GtkWidget *widget, gpointer data);
+void on_replay_file_set(GtkWidget *widget, gpointer data);
+void on_input_source_changed(GtkWidget *widget, gpointer data);
+void on_input_file_set(GtkWidget *widget, gpointer data);
+void on_output_pid_changed(GtkWidget *widget, gpointer data);
 
 int main(int argc, char *argv[]) {
-    filecount = 0;
     // Initialize GTK
     gtk_init(&argc, &argv);
     
-    // Initialize resources
-    initialize_resources();
+    // Attach the GTK front end to the engine and initialize resources
+    EngineClient client = {
+        .log = append_log,
+        .read_input = ui_read_input,
+        .show_output = NULL, // program output goes to the output panel
+        .on_update = ui_on_engine_update
+    };
+    engineSetClient(&client);
+    engineInit();
+    engineSetSnapshots(SNAPSHOT_INTERVAL, 0);
+    engineSetInputGenerator(INPUT_SEED, INPUT_MIN, INPUT_MAX);
+    engineSetOutputRing(OUTPUT_RING_BYTES);
     
     // Initialize UI
     initialize_ui();
@@ -144,428 +193,96 @@ int main(int argc, char *argv[]) {
     // Start the GTK main loop
     gtk_main();
     
+    // Finish a trace that is still recording and keep what programs wrote
+    engineStopTrace();
+    engineSyncFiles();
     return 0;
 }
 
-void executeInstructionUI(char* line, PCB* process) {
-    char command[20], arg1[20], arg2[20];
-    int parsed = sscanf(line, "%s %s %s", command, arg1, arg2);
-    if (parsed < 2) {
-        append_log("Invalid command format");
-        return;
-    }
-
-    if (strcmp(command, "assign") == 0) {
-        if (strcmp(arg2, "input") == 0) {
-            // Create input dialog
-            GtkWidget *dialog = gtk_dialog_new_with_buttons("User Input Required",
-                                                          GTK_WINDOW(window),
-                                                          GTK_DIALOG_MODAL,
-                                                          "OK",
-                                                          GTK_RESPONSE_ACCEPT,
-                                                          "Cancel",
-                                                          GTK_RESPONSE_CANCEL,
-                                                          NULL);
-
-            GtkWidget *content_area = gtk_dialog_get_content_area(GTK_DIALOG(dialog));
-            GtkWidget *entry = gtk_entry_new();
-            GtkWidget *label = gtk_label_new("Please enter a value:");
-
-            gtk_container_add(GTK_CONTAINER(content_area), label);
-            gtk_container_add(GTK_CONTAINER(content_area), entry);
-            gtk_widget_show_all(dialog);
-
-            gint result = gtk_dialog_run(GTK_DIALOG(dialog));
-            if (result == GTK_RESPONSE_ACCEPT) {
-                const gchar *value = gtk_entry_get_text(GTK_ENTRY(entry));
-                setVariable(process, arg1, (char*)value);
-                char log_msg[128];
-                sprintf(log_msg, "Process %d: Assigned user input '%s' to variable %s", 
-                        process->process_id, value, arg1);
-                append_log(log_msg);
-            }
-            gtk_widget_destroy(dialog);
-            
-        } else if (strcmp(arg2, "readFile") == 0) {
-            char nextArg[20];
-            sscanf(line, "%*s %*s %*s %s", nextArg);
-            char* fileName = getVariable(process, nextArg);
-            if (fileName == NULL) {
-                append_log("Variable not found in memory");
-                return;
-            }
-            
-            FILE* file = fopen(fileName, "r");
-            if (file == NULL) {
-                append_log("Error opening file");
-            } else {
-                char content[10000] = {0};
-            size_t totalRead = 0, bytesRead;
-
-            // Read repeatedly until EOF or buffer is full
-            while ((bytesRead = fread(content + totalRead,
-                                    1,
-                                    sizeof(content) - 1 - totalRead,
-                                    file)) > 0) {
-                totalRead += bytesRead;
-                if (totalRead >= sizeof(content) - 1) {
-                    // buffer full, stop reading
-                    break;
-                }
-            }
-            content[totalRead] = '\0';  // ensure null-terminated
-            fclose(file);
-                
-                // Store file content in memory
-                setVariable(process, arg1, content);
-                
-                char log_msg[128];
-                sprintf(log_msg, "Process %d: Read from file '%s' into variable %s", 
-                        process->process_id, fileName, arg1);
-                append_log(log_msg);
-            }
-        } else {
-            setVariable(process, arg1, arg2);
-            char log_msg[128];
-            sprintf(log_msg, "Process %d: Assigned value '%s' to variable %s", 
-                    process->process_id, arg2, arg1);
-            append_log(log_msg);
-        }
-    }
-    else if (strcmp(command, "printFromTo") == 0) {
-        char output[1024] = "";
-        char* start_str = getVariable(process, arg1);
-        char* end_str = getVariable(process, arg2);
-        
-        if (!start_str || !end_str) {
-            append_log("Error: Variables not found in memory");
-            return;
-        }
-        
-        int start = atoi(start_str);
-        int end = atoi(end_str);
-        
-        for (int i = start; i <= end; i++) {
-            char num[16];
-            sprintf(num, "%d\n", i);
-            strcat(output, num);
-        }
-        
-        char log_msg[128];
-        sprintf(log_msg, "Process %d: Printing range %d to %d", process->process_id, start, end);
-        append_log(log_msg);
-        
-        // Show output in dialog
-        GtkWidget *dialog = gtk_dialog_new_with_buttons("Output",
-                                                      GTK_WINDOW(window),
-                                                      GTK_DIALOG_MODAL,
-                                                      "OK",
-                                                      GTK_RESPONSE_ACCEPT,
-                                                      NULL);
-
-        GtkWidget *content_area = gtk_dialog_get_content_area(GTK_DIALOG(dialog));
-        GtkWidget *text_view = gtk_text_view_new();
-        GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view));
-        gtk_text_buffer_set_text(buffer, output, -1);
-        gtk_text_view_set_editable(GTK_TEXT_VIEW(text_view), FALSE);
-
-        gtk_container_add(GTK_CONTAINER(content_area), text_view);
-        gtk_widget_show_all(dialog);
-        gtk_dialog_run(GTK_DIALOG(dialog));
-        gtk_widget_destroy(dialog);
-    } 
-    else if (strcmp(command, "print") == 0) {
-        char* value = getVariable(process, arg1);
-        if (value != NULL) {
-            char log_msg[256];
-            sprintf(log_msg, "Process %d output: %s", process->process_id, value);
-            append_log(log_msg);
-            // Show value in a dialog window
-        GtkWidget *dialog = gtk_dialog_new_with_buttons("Output",
-            GTK_WINDOW(window),
-            GTK_DIALOG_MODAL,
-            "OK",
-            GTK_RESPONSE_ACCEPT,
-            NULL);
-
-        GtkWidget *content_area = gtk_dialog_get_content_area(GTK_DIALOG(dialog));
-        GtkWidget *text_view = gtk_text_view_new();
-        GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view));
-        gtk_text_buffer_set_text(buffer, value, -1);
-        gtk_text_view_set_editable(GTK_TEXT_VIEW(text_view), FALSE);
-
-        gtk_container_add(GTK_CONTAINER(content_area), text_view);
-        gtk_widget_show_all(dialog);
-        gtk_dialog_run(GTK_DIALOG(dialog));
-        gtk_widget_destroy(dialog);
-        } else {
-            char log_msg[256];
-            sprintf(log_msg, "Process %d: Error - Variable %s not found in memory", 
-                    process->process_id, arg1);
-            append_log(log_msg);
-        }
-    } 
-    else if (strcmp(command, "writeFile") == 0) {
-        char* fileName = getVariable(process, arg1);
-        char* data = getVariable(process, arg2);
-        
-        if (!fileName || !data) {
-            append_log("Error: Variables not found in memory");
-            return;
-        }
-        
-        FILE* f = fopen(fileName, "w");
-        if (f) {
-            fprintf(f, "%s", data);
-            fclose(f);
-            char log_msg[128];
-            sprintf(log_msg, "Process %d: Wrote data to file %s", process->process_id, fileName);
-            append_log(log_msg);
-        } else {
-            char log_msg[128];
-            sprintf(log_msg, "Process %d: Error writing to file %s", process->process_id, fileName);
-            append_log(log_msg);
-        }
-    } 
-    else if (strcmp(command, "readFile") == 0) {
-        char* fileName = getVariable(process, arg1);
-        if (!fileName) {
-            append_log("Error: File name variable not found in memory");
-            return;
-        }
-        
-        FILE* f = fopen(fileName, "r");
-        if (f) {
-            char content[1000] = {0};
-            fgets(content, sizeof(content), f);
-            fclose(f);
-            
-            char log_msg[1128];
-            sprintf(log_msg, "Process %d read from file %s: %s", 
-                    process->process_id, fileName, content);
-            append_log(log_msg);
-        } else {
-            char log_msg[128];
-            sprintf(log_msg, "Process %d: Error reading file %s", process->process_id, fileName);
-            append_log(log_msg);
-        }
-    } 
-    else if (strcmp(command, "semWait") == 0) {
-        char log_msg[128];
-        sprintf(log_msg, "Process %d: Waiting for mutex %s", process->process_id, arg1);
-        append_log(log_msg);
-        waitMutex(mutex_converter(arg1), process);
-    } 
-    else if (strcmp(command, "semSignal") == 0) {
-        char log_msg[128];
-        sprintf(log_msg, "Process %d: Signaling mutex %s", process->process_id, arg1);
-        append_log(log_msg);
-        signalMutex(mutex_converter(arg1));
+// Ask the user for the value of "assign x input" in a modal dialog; only
+// used when "Ask with a dialog" is the selected input source
+bool ui_read_input(PCB* process, const char* variable, char* out, int out_size) {
+    flush_log(); // show what led up to the dialog
+    GtkWidget *dialog = gtk_dialog_new_with_buttons("User Input Required",
+                                                  GTK_WINDOW(window),
+                                                  GTK_DIALOG_MODAL,
+                                                  "OK",
+                                                  GTK_RESPONSE_ACCEPT,
+                                                  "Cancel",
+                                                  GTK_RESPONSE_CANCEL,
+                                                  NULL);
+
+    GtkWidget *content_area = gtk_dialog_get_content_area(GTK_DIALOG(dialog));
+    GtkWidget *entry = gtk_entry_new();
+    GtkWidget *label = gtk_label_new("Please enter a value:");
+
+    gtk_container_add(GTK_CONTAINER(content_area), label);
+    gtk_container_add(GTK_CONTAINER(content_area), entry);
+    gtk_widget_show_all(dialog);
+
+    gint result = gtk_dialog_run(GTK_DIALOG(dialog));
+    bool accepted = result == GTK_RESPONSE_ACCEPT;
+    if (accepted) {
+        snprintf(out, out_size, "%s", gtk_entry_get_text(GTK_ENTRY(entry)));
     }
-    
-    update_ui();
+    gtk_widget_destroy(dialog);
+    return accepted;
 }
 
-bool checkFNS(){
-    for (int i = 0;i<process_count;i++){
-        if(processes[i].state!=FINISHED) return true;
+
+
+
+
+// Append one ready-table row for process index i
+static void append_ready_row(int i, const char* queue_name) {
+    PCB* p = &sim->processes[i];
+    char* current_instruction = "N/A";
+    if (p->program_counter < p->instruction_count) {
+        current_instruction = p->program_instructions[p->program_counter];
     }
-    return false;
-}
 
+    GtkTreeIter iter;
+    gtk_list_store_append(ready_queue_store, &iter);
+    gtk_list_store_set(ready_queue_store, &iter,
+        0, p->process_id,  // PID
+        1, current_instruction,  // Current instruction
+        2, queue_name,  // Queue name
+        -1);
+}
 
+// Append one row per queued process; queues hold indices into processes[]
+static void append_queue_rows(const PCBQueue* q, const char* queue_name) {
+    for (int i = 0; i < q->size; i++)
+        append_ready_row(queueAt(q, i), queue_name);
+}
 
 void update_ready_queue_table() {
     // Clear the existing ready queue store
     gtk_list_store_clear(ready_queue_store);
-    // Arrays to hold the preview data
-    int first_queue[QUEUE_CAPACITY];
-    int second_queue[QUEUE_CAPACITY];
-    int third_queue[QUEUE_CAPACITY];
-    int rr_queue[QUEUE_CAPACITY];
-    
-    // Get the queue contents (without modifying them)
-    previewQueue(&firstLevelQueue, first_queue);
-    previewQueue(&secondLevelQueue, second_queue);
-    previewQueue(&thirdLevelQueue, third_queue);
-    previewQueue(&readyQueue, rr_queue);
-    
-    // Add processes from first level queue
-    for (int i = 0; i < firstLevelQueue.size; i++) {
-        GtkTreeIter iter;
-        gtk_list_store_append(ready_queue_store, &iter);
-        
-        int pid = first_queue[i];
-        // Find process by PID
-        for (int j = 0; j < process_count; j++) {
-            if (processes[j].process_id == pid) {
-                char* current_instruction = "N/A";
-                if (processes[j].program_counter < processes[j].instruction_count) {
-                    current_instruction = processes[j].program_instructions[processes[j].program_counter];
-                }
-                
-                gtk_list_store_set(ready_queue_store, &iter,
-                    0, pid,  // PID
-                    1, current_instruction,  // Current instruction
-                    2, "First Level Queue",  // Queue name
-                    -1);
-                break;
-            }
-        }
-    }
-    
-    // Add processes from second level queue
-    for (int i = 0; i < secondLevelQueue.size; i++) {
-        GtkTreeIter iter;
-        gtk_list_store_append(ready_queue_store, &iter);
-        
-        int pid = second_queue[i];
-        // Find process by PID
-        for (int j = 0; j < process_count; j++) {
-            if (processes[j].process_id == pid) {
-                char* current_instruction = "N/A";
-                if (processes[j].program_counter < processes[j].instruction_count) {
-                    current_instruction = processes[j].program_instructions[processes[j].program_counter];
-                }
-                
-                gtk_list_store_set(ready_queue_store, &iter,
-                    0, pid,  // PID
-                    1, current_instruction,  // Current instruction
-                    2, "Second Level Queue",  // Queue name
-                    -1);
-                break;
-            }
-        }
-    }
-    
-    // Add processes from third level queue
-    for (int i = 0; i < thirdLevelQueue.size; i++) {
-        GtkTreeIter iter;
-        gtk_list_store_append(ready_queue_store, &iter);
-        
-        int pid = third_queue[i];
-        // Find process by PID
-        for (int j = 0; j < process_count; j++) {
-            if (processes[j].process_id == pid) {
-                char* current_instruction = "N/A";
-                if (processes[j].program_counter < processes[j].instruction_count) {
-                    current_instruction = processes[j].program_instructions[processes[j].program_counter];
-                }
-                
-                gtk_list_store_set(ready_queue_store, &iter,
-                    0, pid,  // PID
-                    1, current_instruction,  // Current instruction
-                    2, "Third Level Queue",  // Queue name
-                    -1);
-                break;
-            }
-        }
-    }
-    
-    // Add processes from ready queue (RR queue)
-    for (int i = 0; i < readyQueue.size; i++) {
-        GtkTreeIter iter;
-        gtk_list_store_append(ready_queue_store, &iter);
-        
-        int pid = rr_queue[i];
-        // Find process by PID
-        for (int j = 0; j < process_count; j++) {
-            if (processes[j].process_id == pid) {
-                char* current_instruction = "N/A";
-                if (processes[j].program_counter < processes[j].instruction_count) {
-                    current_instruction = processes[j].program_instructions[processes[j].program_counter];
-                }
-                
-                // Determine queue name based on algorithm
-                const char* queue_name = (current_algorithm == MULTILEVEL_FEEDBACK) ? 
-                                       "Fourth Level Queue" : "Ready Queue";
-                
-                gtk_list_store_set(ready_queue_store, &iter,
-                    0, pid,  // PID
-                    1, current_instruction,  // Current instruction
-                    2, queue_name,  // Queue name
-                    -1);
-                break;
-            }
-        }
-    }
-}
-
-// Initialize resources
-void initialize_resources() {
-    // Initialize 3 PCB instances with process_id = -1
-    PCB pcb1 = {
-        .process_id = -1,
-        .state = READY,
-        .priority = 0,
-        .program_counter = 0,
-        .memory_lower_bound = 0,
-        .memory_upper_bound = 0,
-        .program_instructions = {NULL},
-        .instruction_count = 0,
-        .arrival_time = 0,
-        .currentMLFQueue = 0
-    };
 
-    PCB pcb2 = {
-        .process_id = -1,
-        .state = READY,
-        .priority = 1,
-        .program_counter = 0,
-        .memory_lower_bound = 0,
-        .memory_upper_bound = 0,
-        .program_instructions = {NULL},
-        .instruction_count = 0,
-        .arrival_time = 0,
-        .currentMLFQueue = 1
-    };
+    for (int c = 0; c < sim->cpu_count; c++) {
+        // Queue names only carry the core when there is more than one
+        char prefix[16] = "";
+        char queue_name[48];
+        if (sim->cpu_count > 1)
+            sprintf(prefix, "CPU %d ", c);
+
+        // MLFQ levels, highest priority first; only non-empty levels are visited
+        uint64_t levels = sim->mlfqNonEmpty[c];
+        while (levels) {
+            int level = __builtin_ctzll(levels) + 1;
+            sprintf(queue_name, "%sLevel %d Queue", prefix, level);
+            append_queue_rows(&sim->mlfqQueues[c][level - 1], queue_name);
+            levels &= levels - 1;
+        }
 
-    PCB pcb3 = {
-        .process_id = -1,
-        .state = READY,
-        .priority = 2,
-        .program_counter = 0,
-        .memory_lower_bound = 0,
-        .memory_upper_bound = 0,
-        .program_instructions = {NULL},
-        .instruction_count = 0,
-        .arrival_time = 0,
-        .currentMLFQueue = 2
-    };
+        sprintf(queue_name, "%sReady Queue", prefix);
+        append_queue_rows(&sim->readyQueues[c], queue_name);
 
-    PCBMinPQ* pq1 = malloc(sizeof(PCBMinPQ));
-    initMinPQ(pq1);
-    PCBMinPQ* pq2 = malloc(sizeof(PCBMinPQ));
-    initMinPQ(pq2);
-    PCBMinPQ* pq3 = malloc(sizeof(PCBMinPQ));
-    initMinPQ(pq3);
-    
-    // Initialize userInput resource
-    resources[0].name = "userInput";
-    resources[0].available = 1;
-    resources[0].holder_process = &pcb1;
-    resources[0].waiting_count = 0;
-    resources[0].blocked = pq1;
-    
-    // Initialize userOutput resource
-    resources[1].name = "userOutput";
-    resources[1].available = 1;
-    resources[1].holder_process = &pcb2;
-    resources[1].waiting_count = 0;
-    resources[1].blocked = pq2;
-    
-    // Initialize file resource
-    resources[2].name = "file";
-    resources[2].available = 1;
-    resources[2].holder_process = &pcb3;
-    resources[2].waiting_count = 0;
-    resources[2].blocked = pq3;
-    
-    // Initialize memory
-    for (int i = 0; i < MEMORY_SIZE; i++) {
-        memory[i].name = NULL;
-        memory[i].value = NULL;
-        memory[i].allocated = 0;
+        // CFS run tree, least served first
+        sprintf(queue_name, "%sCFS Run Tree", prefix);
+        for (int i = runTreeFirst(&sim->cfsRunQueues[c]); i >= 0; i = runTreeNext(&sim->cfsRunQueues[c], i))
+            append_ready_row(i, queue_name);
     }
 }
 
@@ -588,6 +305,7 @@ void initialize_ui() {
     setup_resource_panel();
     setup_memory_viewer();
     setup_log_console();
+    setup_output_panel();
     setup_process_creation();
     
     // Show all widgets
@@ -624,6 +342,19 @@ void setup_dashboard() {
     algo_label = gtk_label_new("FCFS");
     gtk_box_pack_start(GTK_BOX(overview_box), algo_label, FALSE, FALSE, 5);
     
+    // Running metrics over the processes seen so far
+    GtkWidget *turnaround_text_label = gtk_label_new("Turnaround (mean / p95):");
+    gtk_box_pack_start(GTK_BOX(overview_box), turnaround_text_label, FALSE, FALSE, 5);
+    
+    turnaround_label = gtk_label_new("-");
+    gtk_box_pack_start(GTK_BOX(overview_box), turnaround_label, FALSE, FALSE, 5);
+    
+    GtkWidget *response_text_label = gtk_label_new("Response (mean / p95):");
+    gtk_box_pack_start(GTK_BOX(overview_box), response_text_label, FALSE, FALSE, 5);
+    
+    response_label = gtk_label_new("-");
+    gtk_box_pack_start(GTK_BOX(overview_box), response_label, FALSE, FALSE, 5);
+    
     // Process count label
     GtkWidget *process_count_label = gtk_label_new("Total Processes:");
     gtk_box_pack_start(GTK_BOX(overview_box), process_count_label, FALSE, FALSE, 5);
@@ -748,6 +479,7 @@ void setup_control_panel() {
     gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(algorithm_combo), "First Come First Serve");
     gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(algorithm_combo), "Round Robin");
     gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(algorithm_combo), "Multilevel Feedback Queue");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(algorithm_combo), "Completely Fair Scheduler");
     gtk_combo_box_set_active(GTK_COMBO_BOX(algorithm_combo), 0);
     g_signal_connect(algorithm_combo, "changed", G_CALLBACK(on_algorithm_changed), NULL);
     gtk_box_pack_start(GTK_BOX(algo_box), algorithm_combo, FALSE, FALSE, 0);
@@ -760,10 +492,99 @@ void setup_control_panel() {
     gtk_box_pack_start(GTK_BOX(quantum_box), quantum_label, FALSE, FALSE, 0);
     
     quantum_spin = gtk_spin_button_new_with_range(1, 10, 1);
-    gtk_spin_button_set_value(GTK_SPIN_BUTTON(quantum_spin), quantum);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(quantum_spin), sim->quantum);
     g_signal_connect(quantum_spin, "value-changed", G_CALLBACK(on_quantum_changed), NULL);
     gtk_box_pack_start(GTK_BOX(quantum_box), quantum_spin, FALSE, FALSE, 0);
     
+    // MLFQ levels and priority boost
+    GtkWidget *mlfq_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_box_pack_start(GTK_BOX(control_box), mlfq_box, FALSE, FALSE, 5);
+    
+    GtkWidget *levels_label = gtk_label_new("MLFQ Levels:");
+    gtk_box_pack_start(GTK_BOX(mlfq_box), levels_label, FALSE, FALSE, 0);
+    
+    mlfq_levels_spin = gtk_spin_button_new_with_range(1, MLFQ_MAX_LEVELS, 1);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(mlfq_levels_spin), sim->mlfq_level_count);
+    g_signal_connect(mlfq_levels_spin, "value-changed", G_CALLBACK(on_mlfq_levels_changed), NULL);
+    gtk_box_pack_start(GTK_BOX(mlfq_box), mlfq_levels_spin, FALSE, FALSE, 0);
+    
+    GtkWidget *boost_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_box_pack_start(GTK_BOX(control_box), boost_box, FALSE, FALSE, 5);
+    
+    GtkWidget *boost_label = gtk_label_new("Boost Every (0 = off):");
+    gtk_box_pack_start(GTK_BOX(boost_box), boost_label, FALSE, FALSE, 0);
+    
+    mlfq_boost_spin = gtk_spin_button_new_with_range(0, 10000, 10);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(mlfq_boost_spin), sim->mlfq_boost_interval);
+    g_signal_connect(mlfq_boost_spin, "value-changed", G_CALLBACK(on_mlfq_boost_changed), NULL);
+    gtk_box_pack_start(GTK_BOX(boost_box), mlfq_boost_spin, FALSE, FALSE, 0);
+    
+    // Simulated cores
+    GtkWidget *cpu_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_box_pack_start(GTK_BOX(control_box), cpu_box, FALSE, FALSE, 5);
+    
+    GtkWidget *cpu_label = gtk_label_new("Cores:");
+    gtk_box_pack_start(GTK_BOX(cpu_box), cpu_label, FALSE, FALSE, 0);
+    
+    cpu_count_spin = gtk_spin_button_new_with_range(1, MAX_CPUS, 1);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(cpu_count_spin), sim->cpu_count);
+    g_signal_connect(cpu_count_spin, "value-changed", G_CALLBACK(on_cpu_count_changed), NULL);
+    gtk_box_pack_start(GTK_BOX(cpu_box), cpu_count_spin, FALSE, FALSE, 0);
+    
+    // Cycles a file instruction blocks its process for
+    GtkWidget *disk_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_box_pack_start(GTK_BOX(control_box), disk_box, FALSE, FALSE, 5);
+    
+    GtkWidget *disk_label = gtk_label_new("Disk Latency (0 = off):");
+    gtk_box_pack_start(GTK_BOX(disk_box), disk_label, FALSE, FALSE, 0);
+    
+    disk_latency_spin = gtk_spin_button_new_with_range(0, 1000, 1);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(disk_latency_spin), sim->disk_latency);
+    g_signal_connect(disk_latency_spin, "value-changed", G_CALLBACK(on_disk_latency_changed), NULL);
+    gtk_box_pack_start(GTK_BOX(disk_box), disk_latency_spin, FALSE, FALSE, 0);
+    
+    // Order waiting disk requests are served in; in DiskPolicy order
+    disk_policy_combo = gtk_combo_box_text_new();
+    for (int p = 0; p < DISK_POLICY_COUNT; p++)
+        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(disk_policy_combo), diskPolicyName(p));
+    gtk_combo_box_set_active(GTK_COMBO_BOX(disk_policy_combo), sim->disk_policy);
+    g_signal_connect(disk_policy_combo, "changed", G_CALLBACK(on_disk_policy_changed), NULL);
+    gtk_box_pack_start(GTK_BOX(disk_box), disk_policy_combo, FALSE, FALSE, 0);
+    
+    // Idle fast-forward
+    fast_forward_check = gtk_check_button_new_with_label("Skip idle cycles");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(fast_forward_check), sim->fast_forward_idle);
+    g_signal_connect(fast_forward_check, "toggled", G_CALLBACK(on_fast_forward_toggled), NULL);
+    gtk_box_pack_start(GTK_BOX(control_box), fast_forward_check, FALSE, FALSE, 5);
+    
+    // Execution trace: record this run, or replay a recorded one
+    GtkWidget *trace_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_box_pack_start(GTK_BOX(control_box), trace_box, FALSE, FALSE, 5);
+    
+    record_trace_check = gtk_check_button_new_with_label("Record trace");
+    g_signal_connect(record_trace_check, "toggled", G_CALLBACK(on_record_trace_toggled), NULL);
+    gtk_box_pack_start(GTK_BOX(trace_box), record_trace_check, FALSE, FALSE, 0);
+    
+    replay_chooser_button = gtk_file_chooser_button_new("Replay a Trace", GTK_FILE_CHOOSER_ACTION_OPEN);
+    g_signal_connect(replay_chooser_button, "file-set", G_CALLBACK(on_replay_file_set), NULL);
+    gtk_box_pack_start(GTK_BOX(trace_box), replay_chooser_button, FALSE, FALSE, 0);
+    
+    // Where "assign x input" gets its values
+    GtkWidget *input_source_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_box_pack_start(GTK_BOX(control_box), input_source_box, FALSE, FALSE, 5);
+    
+    input_source_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(input_source_combo), "Generated values");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(input_source_combo), "Values from file");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(input_source_combo), "Ask with a dialog");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(input_source_combo), 0);
+    g_signal_connect(input_source_combo, "changed", G_CALLBACK(on_input_source_changed), NULL);
+    gtk_box_pack_start(GTK_BOX(input_source_box), input_source_combo, FALSE, FALSE, 0);
+    
+    input_chooser_button = gtk_file_chooser_button_new("Input Values", GTK_FILE_CHOOSER_ACTION_OPEN);
+    g_signal_connect(input_chooser_button, "file-set", G_CALLBACK(on_input_file_set), NULL);
+    gtk_box_pack_start(GTK_BOX(input_source_box), input_chooser_button, FALSE, FALSE, 0);
+    
     // Control buttons
     GtkWidget *buttons_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
     gtk_box_pack_start(GTK_BOX(control_box), buttons_box, TRUE, TRUE, 5);
@@ -784,6 +605,21 @@ void setup_control_panel() {
     step_button = gtk_button_new_with_label("Step");
     g_signal_connect(step_button, "clicked", G_CALLBACK(on_step_button_clicked), NULL);
     gtk_box_pack_start(GTK_BOX(buttons_box), step_button, TRUE, TRUE, 0);
+    
+    step_back_button = gtk_button_new_with_label("Step Back");
+    g_signal_connect(step_back_button, "clicked", G_CALLBACK(on_step_back_button_clicked), NULL);
+    gtk_box_pack_start(GTK_BOX(buttons_box), step_back_button, TRUE, TRUE, 0);
+    
+    // Jump back to an earlier clock cycle
+    GtkWidget *goto_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+    gtk_box_pack_start(GTK_BOX(control_box), goto_box, FALSE, FALSE, 5);
+    
+    goto_cycle_spin = gtk_spin_button_new_with_range(0, 100000000, 1);
+    gtk_box_pack_start(GTK_BOX(goto_box), goto_cycle_spin, TRUE, TRUE, 0);
+    
+    goto_cycle_button = gtk_button_new_with_label("Go to Cycle");
+    g_signal_connect(goto_cycle_button, "clicked", G_CALLBACK(on_goto_cycle_clicked), NULL);
+    gtk_box_pack_start(GTK_BOX(goto_box), goto_cycle_button, FALSE, FALSE, 0);
 }
 
 
@@ -885,6 +721,35 @@ void setup_log_console() {
     gtk_box_pack_start(GTK_BOX(log_box), scrolled_window, TRUE, TRUE, 0);
 }
 
+// Setup program output section: the latest output of one process
+void setup_output_panel() {
+    output_frame = gtk_frame_new("Program Output");
+    gtk_box_pack_start(GTK_BOX(main_box), output_frame, TRUE, TRUE, 0);
+    
+    GtkWidget *output_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_container_add(GTK_CONTAINER(output_frame), output_box);
+    
+    GtkWidget *pid_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+    gtk_box_pack_start(GTK_BOX(output_box), pid_box, FALSE, FALSE, 0);
+    
+    GtkWidget *pid_label = gtk_label_new("Process:");
+    gtk_box_pack_start(GTK_BOX(pid_box), pid_label, FALSE, FALSE, 0);
+    
+    output_pid_spin = gtk_spin_button_new_with_range(1, process_limit, 1);
+    g_signal_connect(output_pid_spin, "value-changed", G_CALLBACK(on_output_pid_changed), NULL);
+    gtk_box_pack_start(GTK_BOX(pid_box), output_pid_spin, FALSE, FALSE, 0);
+    
+    output_view = gtk_text_view_new();
+    gtk_text_view_set_editable(GTK_TEXT_VIEW(output_view), FALSE);
+    gtk_text_view_set_monospace(GTK_TEXT_VIEW(output_view), TRUE);
+    output_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(output_view));
+    
+    GtkWidget *scrolled_window = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled_window), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    gtk_container_add(GTK_CONTAINER(scrolled_window), output_view);
+    gtk_box_pack_start(GTK_BOX(output_box), scrolled_window, TRUE, TRUE, 0);
+}
+
 // Setup process creation section
 void setup_process_creation() {
     // Create process creation frame
@@ -905,6 +770,17 @@ void setup_process_creation() {
     g_signal_connect(file_chooser_button, "file-set", G_CALLBACK(on_file_set), NULL);
     gtk_box_pack_start(GTK_BOX(file_box), file_chooser_button, FALSE, FALSE, 0);
     
+    // Host files programs read with readFile; loaded now, not mid-cycle
+    GtkWidget *data_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_box_pack_start(GTK_BOX(process_box), data_box, TRUE, TRUE, 5);
+    
+    GtkWidget *data_label = gtk_label_new("Data File:");
+    gtk_box_pack_start(GTK_BOX(data_box), data_label, FALSE, FALSE, 0);
+    
+    data_file_chooser_button = gtk_file_chooser_button_new("Load a Data File", GTK_FILE_CHOOSER_ACTION_OPEN);
+    g_signal_connect(data_file_chooser_button, "file-set", G_CALLBACK(on_data_file_set), NULL);
+    gtk_box_pack_start(GTK_BOX(data_box), data_file_chooser_button, FALSE, FALSE, 0);
+    
     // Arrival time
     GtkWidget *arrival_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
     gtk_box_pack_start(GTK_BOX(process_box), arrival_box, FALSE, FALSE, 5);
@@ -938,100 +814,117 @@ void setup_process_creation() {
 }
 
 void update_blocked_queue_table(){
-    blocked_queue_count = 0;
-    // Clear the existing ready queue store
-    
+    // Clear the existing blocked queue store
     gtk_list_store_clear(blocked_queue_store);
     
-    // For each resource, get processes from its blocked queue
+    // For each resource, list its blocked queue in wake-up order
     for (int i = 0; i < 3; i++) {
-        PCBMinPQ temp = *(resources[i].blocked); // Make a copy to preserve original -> could not be the issue based on chatgpt
-        PCB blocked_pcb;
-        
-        // Extract processes from the MinPQ
-        while (!isMinPQEmpty(&temp)) {
-            minPQPop(&temp, &blocked_pcb);
-            // Find process index by PID and add to blocked queue
-            for (int j = 0; j < process_count; j++) {
-                if (processes[j].process_id == blocked_pcb.process_id) {
-                    blocked_queue[blocked_queue_count++] = j;
-                    blocked_locations[blocked_queue_count-1] = resources[i].name;
-                    blocked_priority[blocked_queue_count-1] = processes[j].priority;
-                    break;
-                }
-            }
-        } 
+        MinPQIterator it;
+        int j;
+        minPQIterBegin(&it, sim->resources[i].blocked);
+        while (minPQIterNext(&it, &j)) {
+            GtkTreeIter iter;
+            gtk_list_store_append(blocked_queue_store, &iter);
+            gtk_list_store_set(
+                blocked_queue_store,&iter,
+                0, sim->processes[j].process_id,
+                1, sim->resources[i].name,
+                2, sim->processes[j].priority,
+                -1
+            );
+        }
+        minPQIterEnd(&it);
     }
     
-    for(int i = 0;i<blocked_queue_count;i++){
+    // Then the disk: requests in service, then the ones waiting for it
+    const Disk* disk = &sim->disk;
+    for (int r = 0; r < disk->active_count + disk->waiting_count; r++) {
+        int j = r < disk->active_count ? disk->active[r].index
+                                       : disk->waiting[r - disk->active_count].index;
         GtkTreeIter iter;
         gtk_list_store_append(blocked_queue_store, &iter);
         gtk_list_store_set(
             blocked_queue_store,&iter,
-            0, blocked_queue[i]+1,
-            1, blocked_locations[i],
-            2, blocked_priority[i],
+            0, sim->processes[j].process_id,
+            1, r < disk->active_count ? "disk" : "disk (queued)",
+            2, sim->processes[j].priority,
             -1
         );
     }
 }
 
-// Update the UI with current data
-void update_ui() {
-    // Update clock cycle label
-    char clock_str[32];
-    sprintf(clock_str, "%d", clock_cycle);
-    gtk_label_set_text(GTK_LABEL(clock_cycle_label), clock_str);
-    
-    // Update algorithm label
-    switch(current_algorithm) {
-        case FCFS:
-            gtk_label_set_text(GTK_LABEL(algo_label), "FCFS");
+// Fill row i of the process list from the process table
+static void set_process_row(int i) {
+    static int process_rows = 0;
+    GtkTreeIter iter;
+
+    if (i < 0) { // store was cleared
+        process_rows = 0;
+        return;
+    }
+    while (process_rows <= i) {
+        gtk_list_store_append(process_list_store, &iter);
+        process_rows++;
+    }
+    gtk_tree_model_iter_nth_child(GTK_TREE_MODEL(process_list_store), &iter, NULL, i);
+
+    const char* state_str = "";
+    switch (sim->processes[i].state) {
+        case READY:
+            state_str = "Ready";
             break;
-        case ROUND_ROBIN:
-            gtk_label_set_text(GTK_LABEL(algo_label), "Round Robin");
+        case RUNNING:
+            state_str = "Running";
             break;
-        case MULTILEVEL_FEEDBACK:
-            gtk_label_set_text(GTK_LABEL(algo_label), "Multilevel Feedback Queue");
+        case BLOCKED:
+            state_str = "Blocked";
+            break;
+        case FINISHED:
+            state_str = "Finished";
             break;
     }
-    
-    // Update process list
-    gtk_list_store_clear(process_list_store);
-    for (int i = 0; i < process_count; i++) {
-        GtkTreeIter iter;
-        gtk_list_store_append(process_list_store, &iter);
-        
-        char state_str[10];
-        switch (processes[i].state) {
-            case READY:
-                strcpy(state_str, "Ready");
-                break;
-            case RUNNING:
-                strcpy(state_str, "Running");
-                break;
-            case BLOCKED:
-                strcpy(state_str, "Blocked");
-                break;
-            case FINISHED:
-                strcpy(state_str, "Finished");
-                break;
-        }
-        
-        gtk_list_store_set(
-            process_list_store, &iter,
-            0, processes[i].process_id,
-            1, state_str,
-            2, processes[i].priority,
-            3, processes[i].program_counter,
-            4, processes[i].memory_lower_bound,
-            5, processes[i].memory_upper_bound,
-            -1
-        );
+
+    gtk_list_store_set(
+        process_list_store, &iter,
+        0, sim->processes[i].process_id,
+        1, state_str,
+        2, sim->processes[i].priority,
+        3, sim->processes[i].program_counter,
+        4, sim->processes[i].memory_lower_bound,
+        5, sim->processes[i].memory_upper_bound,
+        -1
+    );
+}
+
+// Fill row i of the memory view from the simulated memory
+static void set_memory_row(int i) {
+    static int memory_rows = 0;
+    GtkTreeIter iter;
+
+    if (i < 0) { // store was cleared
+        memory_rows = 0;
+        return;
     }
-    
-    // Update running process label
-    
+    while (memory_rows <= i) {
+        gtk_list_store_append(memory_store, &iter);
+        memory_rows++;
+    }
+    gtk_tree_model_iter_nth_child(GTK_TREE_MODEL(memory_store), &iter, NULL, i);
+
+    char* name = sim->memory[i].allocated ? sim->memory[i].name : "Free";
+    char* value = sim->memory[i].allocated ? sim->memory[i].value : "-";
+
+    gtk_list_store_set(
+        memory_store, &iter,
+        0, i,
+        1, name,
+        2, value,
+        -1
+    );
+}
+
+// Update the resource status labels
+static void update_resource_labels() {
     for (int i = 0; i < 3; i++) {
         GtkWidget* status_label;
         char status_str[32];
@@ -1043,85 +936,233 @@ void update_ui() {
             case 1: // userOutput
                 status_label = user_output_status;
                 break;
-            case 2: // file
+            default: // file
                 status_label = file_status;
                 break;
         }
         
-        if (resources[i].available) {
+        if (sim->resources[i].available) {
             strcpy(status_str, "Available");
         } else {
-            sprintf(status_str, "Held by P%d", resources[i].holder_process->process_id);
+            sprintf(status_str, "Held by P%d", sim->resources[i].holder + 1);
         }
         
         gtk_label_set_text(GTK_LABEL(status_label), status_str);
     }
+}
+
+// Update the UI with what changed in the engine since the last refresh.
+// Only dirty process and memory rows are rewritten in place; the queue and
+// resource views are rebuilt only when their contents changed.
+void update_ui() {
+    const EngineChanges* changes = engineChanges();
+
+    // Update clock cycle label
+    char clock_str[32];
+    sprintf(clock_str, "%d", sim->clock_cycle);
+    gtk_label_set_text(GTK_LABEL(clock_cycle_label), clock_str);
     
-    // Update memory view
-    gtk_list_store_clear(memory_store);
-    for (int i = 0; i < MEMORY_SIZE; i++) {
-        GtkTreeIter iter;
-        gtk_list_store_append(memory_store, &iter);
-        
-        char* name = memory[i].allocated ? memory[i].name : "Free";
-        char* value = memory[i].allocated ? memory[i].value : "-";
-        
-        gtk_list_store_set(
-            memory_store, &iter,
-            0, i,
-            1, name,
-            2, value,
-            -1
-        );
+    // Update algorithm label
+    gtk_label_set_text(GTK_LABEL(algo_label), engineAlgorithmName(sim->current_algorithm));
+    
+    // Update metric labels
+    const Histogram* turnaround = engineMetric(METRIC_TURNAROUND);
+    const Histogram* response = engineMetric(METRIC_RESPONSE);
+    char metric_str[64] = "-";
+    if (turnaround->count > 0)
+        sprintf(metric_str, "%.2f / %d", histogramMean(turnaround), histogramPercentile(turnaround, 95));
+    gtk_label_set_text(GTK_LABEL(turnaround_label), metric_str);
+    strcpy(metric_str, "-");
+    if (response->count > 0)
+        sprintf(metric_str, "%.2f / %d", histogramMean(response), histogramPercentile(response, 95));
+    gtk_label_set_text(GTK_LABEL(response_label), metric_str);
+    
+    if (changes->flags & CHANGED_ALL) {
+        gtk_list_store_clear(process_list_store);
+        gtk_list_store_clear(memory_store);
+        set_process_row(-1);
+        set_memory_row(-1);
+        for (int i = 0; i < sim->process_count; i++)
+            set_process_row(i);
+        for (int i = 0; i < sim->memory_size; i++)
+            set_memory_row(i);
+    } else {
+        for (int i = 0; i < changes->process_count; i++)
+            set_process_row(changes->processes[i]);
+        for (int i = 0; i < changes->word_count; i++)
+            set_memory_row(changes->words[i]);
+    }
+
+    if (changes->flags & (CHANGED_ALL | CHANGED_QUEUES))
+        update_ready_queue_table();
+    if (changes->flags & (CHANGED_ALL | CHANGED_RESOURCES)) {
+        update_resource_labels();
+        update_blocked_queue_table();
     }
-    update_ready_queue_table();
-    update_blocked_queue_table();
+    update_output_panel();
+
+    engineClearChanges();
 }
 
-// Append message to log
+// Show what the engine kept of the selected process's output; only redrawn
+// when that process wrote something
+void update_output_panel() {
+    static char text[OUTPUT_RING_BYTES + 1];
+    int pid = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(output_pid_spin));
+    long long written = outputRingWritten(&sim->output, pid);
+    if (pid == output_shown_pid && written == output_shown_written)
+        return;
+    output_shown_pid = pid;
+    output_shown_written = written;
+    
+    int length = outputRingRead(&sim->output, pid, text, sizeof(text));
+    gtk_text_buffer_set_text(output_buffer, text, length);
+    
+    // Scroll to the newest output
+    GtkTextIter iter;
+    gtk_text_buffer_get_end_iter(output_buffer, &iter);
+    gtk_text_view_scroll_to_iter(GTK_TEXT_VIEW(output_view), &iter, 0.0, FALSE, 0.0, 0.0);
+}
+
+// Queue a log message; it reaches the text view on the next refresh tick
 void append_log(const char* message) {
+    // Ring full: overwrite the oldest pending message
+    if (log_count == LOG_RING_SIZE) {
+        log_head = (log_head + 1) % LOG_RING_SIZE;
+        log_count--;
+        log_dropped++;
+    }
+
+    LogEntry* entry = &log_ring[(log_head + log_count) % LOG_RING_SIZE];
+    entry->clock = sim->clock_cycle;
+    snprintf(entry->text, sizeof(entry->text), "%s", message);
+    log_count++;
+
+    ui_on_engine_update();
+}
+
+// Write all pending log messages to the text view in one insert and trim
+// the view to the last LOG_MAX_LINES lines
+void flush_log() {
+    if (log_count == 0 && log_dropped == 0)
+        return;
+
+    size_t capacity = (size_t)log_count * (LOG_LINE_LENGTH + 24) + 64;
+    char* batch = malloc(capacity);
+    if (!batch)
+        return;
+
+    size_t len = 0;
+    if (log_dropped > 0)
+        len += snprintf(batch + len, capacity - len, "... %d log messages dropped\n", log_dropped);
+    for (int i = 0; i < log_count; i++) {
+        const LogEntry* entry = &log_ring[(log_head + i) % LOG_RING_SIZE];
+        len += snprintf(batch + len, capacity - len, "[Cycle %d] %s\n", entry->clock, entry->text);
+    }
+    log_head = 0;
+    log_count = 0;
+    log_dropped = 0;
+
     GtkTextIter iter;
     gtk_text_buffer_get_end_iter(log_buffer, &iter);
-    
-    // Add timestamp
-    time_t now = time(NULL);
-    struct tm *t = localtime(&now);
-    char timestamp[64];
-    strftime(timestamp, sizeof(timestamp), "[%H:%M:%S] ", t);
-    
-    // Append log with timestamp
-    gtk_text_buffer_insert(log_buffer, &iter, timestamp, -1);
-    gtk_text_buffer_insert(log_buffer, &iter, message, -1);
-    gtk_text_buffer_insert(log_buffer, &iter, "\n", -1);
-    
+    gtk_text_buffer_insert(log_buffer, &iter, batch, (gint)len);
+    free(batch);
+
+    // The buffer always ends with an empty line after the final newline
+    int excess = gtk_text_buffer_get_line_count(log_buffer) - 1 - LOG_MAX_LINES;
+    if (excess > 0) {
+        GtkTextIter start, cut;
+        gtk_text_buffer_get_start_iter(log_buffer, &start);
+        gtk_text_buffer_get_iter_at_line(log_buffer, &cut, excess);
+        gtk_text_buffer_delete(log_buffer, &start, &cut);
+    }
+
     // Scroll to the end
+    gtk_text_buffer_get_end_iter(log_buffer, &iter);
     gtk_text_view_scroll_to_iter(GTK_TEXT_VIEW(log_view), &iter, 0.0, FALSE, 0.0, 0.0);
 }
 
-// Updated start_simulation() to schedule simulation_tick periodically (e.g., every 1000ms)
+// Drop pending log messages and empty the text view
+void clear_log() {
+    log_head = 0;
+    log_count = 0;
+    log_dropped = 0;
+    gtk_text_buffer_set_text(log_buffer, "", -1);
+}
+
+// Coalesced redraw fired by the refresh timer
+static gboolean refresh_ui(gpointer data) {
+    refresh_source_id = 0;
+    flush_log();
+    update_ui();
+    return G_SOURCE_REMOVE;
+}
+
+// Engine state changed; the engine records what changed, so just make sure a
+// redraw is pending instead of repainting after every instruction
+void ui_on_engine_update() {
+    if (refresh_source_id == 0)
+        refresh_source_id = g_timeout_add(REFRESH_INTERVAL_MS, refresh_ui, NULL);
+}
+
+// Run engine steps for at most one frame, then hand the main loop back to GTK
+// so redraws and the Stop button are handled between chunks
+gboolean run_simulation_chunk(gpointer data) {
+    gint64 deadline = g_get_monotonic_time() + RUN_CHUNK_BUDGET_US;
+
+    while (simulation_running && engineHasUnfinished() &&
+           g_get_monotonic_time() < deadline) {
+        step_simulation();
+    }
+
+    if (simulation_running && engineHasUnfinished())
+        return G_SOURCE_CONTINUE;
+
+    // Show the final state right away rather than on the next refresh tick
+    flush_log();
+    update_ui();
+
+    // Finished (or stopped): drop the source and restore the controls
+    run_source_id = 0;
+    simulation_running = FALSE;
+    gtk_widget_set_sensitive(start_button, TRUE);
+    gtk_widget_set_sensitive(stop_button, FALSE);
+    gtk_widget_set_sensitive(step_button, TRUE);
+    gtk_widget_set_sensitive(step_back_button, TRUE);
+    gtk_widget_set_sensitive(goto_cycle_button, TRUE);
+    return G_SOURCE_REMOVE;
+}
+
+// Start a continuous run driven by the GTK main loop in time-sliced chunks
 void start_simulation() {
-    mode = 1;
     if (!simulation_running) {
         simulation_running = TRUE;
         append_log("Simulation started");
     }
     gtk_widget_set_sensitive(start_button, FALSE);
     gtk_widget_set_sensitive(stop_button, TRUE);
-    while(simulation_running&&checkFNS()){
-        step_simulation();        
-    }
-    gtk_widget_set_sensitive(start_button, TRUE);
-    gtk_widget_set_sensitive(stop_button, FALSE);
+    gtk_widget_set_sensitive(step_button, FALSE);
+    gtk_widget_set_sensitive(step_back_button, FALSE);
+    gtk_widget_set_sensitive(goto_cycle_button, FALSE);
+    if (run_source_id == 0)
+        run_source_id = g_idle_add(run_simulation_chunk, NULL);
 }
 
-// Updated stop_simulation() to cancel~ the simulation timer
+// Stop a continuous run; takes effect before the next chunk starts
 void stop_simulation() {
     if (simulation_running) {
         simulation_running = FALSE;
         append_log("Simulation stopped");
     }
+    if (run_source_id != 0) {
+        g_source_remove(run_source_id);
+        run_source_id = 0;
+    }
     gtk_widget_set_sensitive(start_button, TRUE);
     gtk_widget_set_sensitive(stop_button, FALSE);
+    gtk_widget_set_sensitive(step_button, TRUE);
+    gtk_widget_set_sensitive(step_back_button, TRUE);
+    gtk_widget_set_sensitive(goto_cycle_button, TRUE);
 }
 
 // Reset simulation
@@ -1131,93 +1172,76 @@ void reset_simulation() {
         stop_simulation();
     }
     
-    // Reset clock
-    clock_cycle = 0;
+    // Keep what the programs wrote, then reset clock, processes, queues,
+    // resources and memory; this also finishes a trace that was recording
+    engineSyncFiles();
+    engineReset();
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(record_trace_check), FALSE);
     
-    // Clear processes
-    process_count = 0;
-    running_process_index = -1;
-    
-    // Reset all queues
-    initQueue(&firstLevelQueue);
-    initQueue(&secondLevelQueue);
-    initQueue(&thirdLevelQueue);
-    initQueue(&readyQueue);
-    
-    // Reset resources
-    initialize_resources();
-    
-    // Reset memory
-    for (int i = 0; i < MEMORY_SIZE; i++) {
-        if (memory[i].allocated) {
-            free(memory[i].name);
-            free(memory[i].value);
-        }
-        memory[i].name = NULL;
-        memory[i].value = NULL;
-        memory[i].allocated = 0;
-    }
-    idleCount = 0;
-    for(int i = 0;i<filecount;i++){
-        memset(file_names[i], 0, 244);
-    }
-    filecount = 0;
     // Update UI
     update_ui();
     
     // Clear log
-    gtk_text_buffer_set_text(log_buffer, "", -1);
+    clear_log();
     
     append_log("Simulation reset - All data structures cleared");
 }
 
 // Step simulation by one clock cycle
 void step_simulation() {
-    //condition to end start -> nothing to run
-   // simulation_running = false;
-   // return;
-
-    step = true;
-    mode = 2;
-    // Increment clock cycle
-   // clock_cycle++;
-    
-    // TODO: Implement actual scheduling logic
-    switch (current_algorithm)
-    {
-    case ROUND_ROBIN:
-        roundRobin();
-        break;
-    case FCFS:
-        fcfs();
-        break;
-    case MULTILEVEL_FEEDBACK:
-        mlfq();
-        break;
-    default:
-        append_log("No such scheduling algorithm ya 3am");
-        break;
+    engineStep();
+}
+
+// Updated step button handler to run one simulation tick when not running continuously
+void on_step_button_clicked(GtkWidget *widget, gpointer data) {
+    step_simulation();
+}
+
+// Undo the last clock tick: the engine restores its newest snapshot before
+// it and re-runs the cycles in between without output
+void step_back_simulation() {
+    if (!engineStepBack()) {
+        append_log("Nothing to step back to");
         return;
     }
+    sync_settings_widgets();
     update_ui();
-    if (current_algorithm!= MULTILEVEL_FEEDBACK) 
-    {
-        char log_message[64];
-    sprintf(log_message, "Clock cycle %d completed", clock_cycle-1);
-    append_log(log_message);
+}
+
+void goto_cycle() {
+    int cycle = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(goto_cycle_spin));
+    if (!engineRestoreCycle(cycle)) {
+        append_log("Can only go back to an earlier cycle of this run");
+        return;
     }
-    
-    
+    sync_settings_widgets();
+    update_ui();
 }
 
-// Updated step button handler to run one simulation tick when not running continuously
-void on_step_button_clicked(GtkWidget *widget, gpointer data) {
-    step_simulation();
+// A restored cycle brings back the settings it ran with; show them
+void sync_settings_widgets() {
+    gtk_combo_box_set_active(GTK_COMBO_BOX(algorithm_combo), sim->current_algorithm);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(quantum_spin), sim->quantum);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(mlfq_levels_spin), sim->mlfq_level_count);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(mlfq_boost_spin), sim->mlfq_boost_interval);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(cpu_count_spin), sim->cpu_count);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(disk_latency_spin), sim->disk_latency);
+    gtk_combo_box_set_active(GTK_COMBO_BOX(disk_policy_combo), sim->disk_policy);
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(fast_forward_check), sim->fast_forward_idle);
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(record_trace_check), sim->trace != NULL);
+}
+
+void on_step_back_button_clicked(GtkWidget *widget, gpointer data) {
+    step_back_simulation();
+}
+
+void on_goto_cycle_clicked(GtkWidget *widget, gpointer data) {
+    goto_cycle();
 }
 
 // Add a new process
 void add_process() {
-    if (process_count >= MAX_PROCESSES) {
+    if (sim->process_count >= process_limit) {
         append_log("Error: Maximum number of processes reached");
         return;
     }
@@ -1252,108 +1276,24 @@ void add_process() {
     }
     fclose(source);
     fclose(dest);
-    strncpy(file_names[filecount++], filename, 255); // Change to use strncpy
-    file_names[filecount-1][255] = '\0'; // Ensure null termination
-    char filename_log[256];
-    sprintf(filename_log, "filename is %s", file_names[filecount-1]);
+    char filename_log[300];
+    snprintf(filename_log, sizeof(filename_log), "filename is %s", filename);
     append_log(filename_log);
     
-    // Update file_path to use the new location
-    g_free(file_path);
-    file_path = strdup(new_path);
-    
     // Get arrival time
     int arrival_time = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(arrival_time_spin));
     
     // Get priority - Add this line
     int priority = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(priority_spin));
     
-    // Create new process with dummy data for demonstration
-    PCB new_process;
-    new_process.process_id = process_count + 1;
-    new_process.state = READY;
-    new_process.priority = priority; // Use selected priority instead of default
-    new_process.program_counter = 0;
-    new_process.memory_lower_bound = process_count * 20;
-    new_process.memory_upper_bound = (process_count + 1) * 20 - 1;
-    new_process.arrival_time = arrival_time;
-
-    // Read instructions from file
-    FILE* file = fopen(file_path, "r");
-    char line[256];
-    int idx = 0;
-    while (fgets(line, sizeof(line), file) && idx < 20) {  // Add bound check
-        // Remove newline if present
-        size_t len = strlen(line);
-        if (len > 0 && line[len-1] == '\n') {
-            line[len-1] = '\0';
-        }
-        char* instruction = strdup(line);
-        if (instruction == NULL) {  // Check for allocation failure
-            append_log("Error: Memory allocation failed for instruction");
-            fclose(file);
-            g_free(file_path);
-            // Clean up previously allocated instructions
-            for (int i = 0; i < idx; i++) {
-                free(new_process.program_instructions[i]);
-            }
-            return;
-        }
-        new_process.program_instructions[idx] = instruction;
-        idx++;
-    }
-    // Set the actual amount of instructions read
-    new_process.instruction_count = idx;
-
-    // Set remaining instruction pointers to NULL
-    for (int i = idx; i < 20; i++) {
-        new_process.program_instructions[i] = NULL;
-    }
-
-    fclose(file);
-    
-    // Add process to list
-    processes[process_count] = new_process;
-    process_count++;
-    
-    
-    // Allocate memory for process
-    for (int i = new_process.memory_lower_bound; i <= new_process.memory_upper_bound; i++) {
-        memory[i].allocated = 1;
-        
-        // Set memory values
-        if (i == new_process.memory_lower_bound) {
-            memory[i].name = strdup("State");
-            memory[i].value = strdup("Ready");
-        } else if (i == new_process.memory_lower_bound + 1) {
-            memory[i].name = strdup("PC");
-            memory[i].value = strdup("0");
-        } else if (i == new_process.memory_lower_bound + 2) {
-            memory[i].name = strdup("Priority");
-            char priority_str[16];
-            sprintf(priority_str, "%d", new_process.priority);
-            memory[i].value = strdup(priority_str);
-        } else if (i < new_process.memory_lower_bound + 3 + new_process.instruction_count) {
-            char var_name[32];
-            sprintf(var_name, "Inst%d", i - new_process.memory_lower_bound - 2);
-            memory[i].name = strdup(var_name);
-            memory[i].value = strdup(new_process.program_instructions[i - new_process.memory_lower_bound - 3]);
-        } else {
-            char var_name[32];
-            sprintf(var_name, "Var%d", i - new_process.memory_lower_bound - (new_process.instruction_count+2));
-            memory[i].name = strdup(var_name);
-            memory[i].value = strdup("NULL");
-        }
+    // Load the copied program into the engine
+    int pid = engineAddProcess(new_path, arrival_time, priority);
+    if (pid >= 0) {
+        char log_message[384];
+        snprintf(log_message, sizeof(log_message), "Added process PID=%d with arrival time=%d from file %s", 
+                pid, arrival_time, filename);
+        append_log(log_message);
     }
-    
-    update_ui();
-    
-    char log_message[128];
-    sprintf(log_message, "Added process PID=%d with arrival time=%d from file %s", 
-            new_process.process_id, arrival_time, 
-            strrchr(file_path, '/') ? strrchr(file_path, '/') + 1 : file_path);
-    append_log(log_message);
-    
     g_free(file_path);
 }
 
@@ -1363,20 +1303,25 @@ void change_algorithm() {
     
     switch (active) {
         case 0:
-            current_algorithm = FCFS;
+            sim->current_algorithm = FCFS;
             append_log("Scheduling algorithm changed to First Come First Serve");
             gtk_widget_set_sensitive(quantum_spin, FALSE);
             break;
         case 1:
-            current_algorithm = ROUND_ROBIN;
+            sim->current_algorithm = ROUND_ROBIN;
             append_log("Scheduling algorithm changed to Round Robin");
             gtk_widget_set_sensitive(quantum_spin, TRUE);
             break;
         case 2:
-            current_algorithm = MULTILEVEL_FEEDBACK;
+            sim->current_algorithm = MULTILEVEL_FEEDBACK;
             append_log("Scheduling algorithm changed to Multilevel Feedback Queue");
             gtk_widget_set_sensitive(quantum_spin, FALSE);
             break;
+        case 3:
+            sim->current_algorithm = CFS;
+            append_log("Scheduling algorithm changed to Completely Fair Scheduler");
+            gtk_widget_set_sensitive(quantum_spin, FALSE);
+            break;
     }
     //reset_simulation();
     update_ui();
@@ -1410,11 +1355,190 @@ void on_algorithm_changed(GtkWidget *widget, gpointer data) {
 
 // Signal handler for quantum changed
 void on_quantum_changed(GtkWidget *widget, gpointer data) {
-    quantum = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(quantum_spin));
+    sim->quantum = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(quantum_spin));
     
     char log_message[32];
-    sprintf(log_message, "Quantum changed to %d", quantum);
+    sprintf(log_message, "Quantum changed to %d", sim->quantum);
+    append_log(log_message);
+}
+
+// Signal handler for MLFQ level count changed (quanta stay 1, 2, 4, ... per level)
+void on_mlfq_levels_changed(GtkWidget *widget, gpointer data) {
+    int levels = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(mlfq_levels_spin));
+    mlfqConfigure(levels, NULL);
+    engineMarkChanged(CHANGED_QUEUES);
+    ui_on_engine_update();
+    
+    char log_message[48];
+    sprintf(log_message, "MLFQ levels changed to %d", levels);
+    append_log(log_message);
+}
+
+// Signal handler for MLFQ priority boost interval changed
+void on_mlfq_boost_changed(GtkWidget *widget, gpointer data) {
+    sim->mlfq_boost_interval = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(mlfq_boost_spin));
+    
+    char log_message[64];
+    if (sim->mlfq_boost_interval > 0)
+        sprintf(log_message, "MLFQ priority boost every %d cycles", sim->mlfq_boost_interval);
+    else
+        sprintf(log_message, "MLFQ priority boost disabled");
+    append_log(log_message);
+}
+
+// Signal handler for disk latency changed; applies to requests issued from now on
+void on_disk_latency_changed(GtkWidget *widget, gpointer data) {
+    int latency = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(disk_latency_spin));
+    engineSetDisk(latency, sim->disk_queue_depth);
+    
+    char log_message[64];
+    if (latency > 0)
+        sprintf(log_message, "File instructions take %d cycles on the disk", latency);
+    else
+        sprintf(log_message, "File instructions complete immediately");
+    append_log(log_message);
+}
+
+// Signal handler for disk scheduling policy changed
+void on_disk_policy_changed(GtkWidget *widget, gpointer data) {
+    int policy = gtk_combo_box_get_active(GTK_COMBO_BOX(disk_policy_combo));
+    if (!engineSetDiskPolicy(policy))
+        return;
+    
+    char log_message[64];
+    sprintf(log_message, "Disk requests served in %s order", diskPolicyName(policy));
+    append_log(log_message);
+}
+
+// Signal handler for core count changed; only allowed before the first cycle
+void on_cpu_count_changed(GtkWidget *widget, gpointer data) {
+    int count = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(cpu_count_spin));
+    if (count == sim->cpu_count)
+        return;
+    
+    char log_message[96];
+    if (engineSetCpuCount(count)) {
+        sprintf(log_message, "Simulating %d core%s", count, count == 1 ? "" : "s");
+        ui_on_engine_update();
+    } else {
+        sprintf(log_message, "Reset the simulation before changing the number of cores");
+        gtk_spin_button_set_value(GTK_SPIN_BUTTON(cpu_count_spin), sim->cpu_count);
+    }
+    append_log(log_message);
+}
+
+// Signal handler for idle fast-forward toggle
+void on_fast_forward_toggled(GtkWidget *widget, gpointer data) {
+    sim->fast_forward_idle = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(fast_forward_check));
+    append_log(sim->fast_forward_idle ? "Idle cycles will be skipped" : "Idle cycles will be stepped one by one");
+}
+
+// Signal handler for the record trace toggle; recording has to start before
+// the first process is added
+void on_record_trace_toggled(GtkWidget *widget, gpointer data) {
+    char log_message[128];
+    if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(record_trace_check))) {
+        if (engineStartTrace(TRACE_FILE_NAME)) {
+            sprintf(log_message, "Recording trace to %s", TRACE_FILE_NAME);
+            append_log(log_message);
+        } else {
+            append_log("Reset the simulation before recording a trace");
+            gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(record_trace_check), FALSE);
+        }
+    } else if (engineStopTrace()) {
+        sprintf(log_message, "Trace saved to %s", TRACE_FILE_NAME);
+        append_log(log_message);
+    }
+}
+
+// Signal handler for the replay file chooser: rebuild the run from the trace;
+// Start and Step then replay it without executing instructions
+void on_replay_file_set(GtkWidget *widget, gpointer data) {
+    char* file_path = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(widget));
+    if (!file_path)
+        return;
+    if (simulation_running)
+        stop_simulation();
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(record_trace_check), FALSE);
+    
+    clear_log();
+    if (engineStartReplay(file_path)) {
+        append_log("Replaying trace - use Start or Step to advance");
+    } else {
+        append_log("Error: Could not read trace file");
+    }
+    update_ui();
+    g_free(file_path);
+}
+
+// Hand the input source picked in the control panel to the engine
+void select_input_source() {
+    char log_message[128];
+    switch (gtk_combo_box_get_active(GTK_COMBO_BOX(input_source_combo))) {
+    case 0:
+        engineSetInputGenerator(INPUT_SEED, INPUT_MIN, INPUT_MAX);
+        sprintf(log_message, "Input values are generated (%d to %d)", INPUT_MIN, INPUT_MAX);
+        append_log(log_message);
+        break;
+    case 1: {
+        char* file_path = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(input_chooser_button));
+        if (!file_path) {
+            append_log("Choose a file of input values");
+        } else if (engineSetInputFile(file_path)) {
+            snprintf(log_message, sizeof(log_message), "Input values from %s",
+                    strrchr(file_path, '/') ? strrchr(file_path, '/') + 1 : file_path);
+            append_log(log_message);
+        } else {
+            append_log("Error: Could not read the input values file");
+        }
+        g_free(file_path);
+        break;
+    }
+    default:
+        engineUseInputClient();
+        append_log("Input values will be asked for in a dialog");
+        break;
+    }
+}
+
+// Signal handler for the input source combo
+void on_input_source_changed(GtkWidget *widget, gpointer data) {
+    select_input_source();
+}
+
+// Signal handler for the input values file chooser: choosing a file selects it
+void on_input_file_set(GtkWidget *widget, gpointer data) {
+    if (gtk_combo_box_get_active(GTK_COMBO_BOX(input_source_combo)) == 1)
+        select_input_source();
+    else
+        gtk_combo_box_set_active(GTK_COMBO_BOX(input_source_combo), 1);
+}
+
+// Signal handler for the output panel's process selector
+void on_output_pid_changed(GtkWidget *widget, gpointer data) {
+    update_output_panel();
+}
+
+// Signal handler for the data file chooser. Programs name files relative to
+// the working directory, so files under it are loaded by their relative path.
+void on_data_file_set(GtkWidget *widget, gpointer data) {
+    char* file_path = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(widget));
+    if (file_path == NULL)
+        return;
+    char* cwd = g_get_current_dir();
+    size_t cwd_length = strlen(cwd);
+    const char* name = file_path;
+    if (strncmp(file_path, cwd, cwd_length) == 0 && file_path[cwd_length] == '/')
+        name = file_path + cwd_length + 1;
+    
+    char log_message[MAX_PATH_LENGTH + 32];
+    if (engineLoadFile(name))
+        snprintf(log_message, sizeof(log_message), "Loaded data file %s", name);
+    else
+        snprintf(log_message, sizeof(log_message), "Could not read %s", name);
     append_log(log_message);
+    g_free(cwd);
+    g_free(file_path);
 }
 
 // Signal handler for file chooser
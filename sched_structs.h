@@ -1,18 +1,12 @@
 
- #define MEMORY_SIZE 60
- #define MAX_PROCESSES 60
+ #define DEFAULT_PROCESS_LIMIT 1000000 // Upper bound on processes unless set at startup
+ #define WORDS_PER_PROCESS 20             // Simulated memory words given to each process
  #define MAX_PATH_LENGTH 256
+ #define MAX_INSTRUCTIONS 20
+ #define MAX_VARIABLES 10
 
  #include <stdbool.h>
 
-#ifndef QUEUE_CAPACITY
-#define QUEUE_CAPACITY  60
-#endif
-
-#ifndef HEAP_CAPACITY
-#define HEAP_CAPACITY   60
-#endif
-
   // Enum for process states
 typedef enum {
     READY,
@@ -25,9 +19,34 @@ typedef enum {
 typedef enum {
     FCFS,
     ROUND_ROBIN,
-    MULTILEVEL_FEEDBACK
+    MULTILEVEL_FEEDBACK,
+    CFS
 } SchedulingAlgorithm;
 
+// Opcodes for pre-decoded program instructions
+typedef enum {
+    OP_INVALID,
+    OP_ASSIGN_VALUE,    // assign x <literal>
+    OP_ASSIGN_INPUT,    // assign x input
+    OP_ASSIGN_READFILE, // assign x readFile y
+    OP_PRINT,           // print x
+    OP_PRINT_FROM_TO,   // printFromTo x y
+    OP_WRITE_FILE,      // writeFile x y
+    OP_READ_FILE,       // readFile x
+    OP_SEM_WAIT,        // semWait resource
+    OP_SEM_SIGNAL       // semSignal resource
+} Opcode;
+
+// One decoded instruction, operands are variable slot ids into PCB.var_names
+typedef struct {
+    unsigned char opcode;
+    signed char dst;      // destination slot (assign), -1 if unused
+    signed char src1;     // first operand slot, -1 if unused
+    signed char src2;     // second operand slot, -1 if unused
+    signed char resource; // index into resources[] for semWait/semSignal
+    char* literal;        // value for assign x <literal>
+} Instruction;
+
 // Struct for Process Control Block
 typedef struct {
     int process_id;
@@ -36,40 +55,97 @@ typedef struct {
     int program_counter;
     int memory_lower_bound;
     int memory_upper_bound;
-    char* program_instructions[20]; // Assuming max 20 instructions per program
+    char* program_instructions[MAX_INSTRUCTIONS]; // Source text, kept for display
     int instruction_count;
+    Instruction* code;                   // Decoded once by compileProgram()
+    char* var_names[MAX_VARIABLES];      // Operand slot id -> variable name
+    int var_count;
+    int var_base;                        // Memory address of variable slot 0
+    unsigned var_assigned;               // Bit i set once slot i holds a value
     int arrival_time;
     int currentMLFQueue;
+    int slice_used;  // Cycles run since the process was last dispatched
+    int boost_epoch; // For MLFQ: priority boosts this process has seen
+    long long vruntime; // For CFS: CPU time weighted by priority
+    int first_run;      // Clock cycle of the first dispatch, -1 until then
+    int finish_time;    // Clock cycle the last instruction completed, -1 until then
+    int cpu;            // Core the process was last queued on or ran on
+    int ready_cycles;      // Cycles spent in a ready queue
+    int blocked_cycles[3]; // Cycles blocked on each resource (same order as resources[])
+    int context_switches;  // Times the process was dispatched onto a core
+    int state_since;       // Clock cycle it last became READY or BLOCKED
+    int inputs_read;       // Values read by "assign x input" so far
+    int io_cycles;         // Cycles blocked on disk requests
     bool shiftDown; // For MLFQ
+    bool dirty;     // Changed since the front end last refreshed
 } PCB;
+// FIFO of process-table indices (processes[] stays the only copy of each PCB)
 typedef struct {
-    PCB    data[QUEUE_CAPACITY];
+    int*   data;     // ring buffer of indices into processes[], grown on demand
+    int    capacity; // allocated slots
     int    head;   // index for next dequeue
     int    tail;   // index for next enqueue
     int    size;   // current number of elements
 } PCBQueue;
 
-// Priority Queue structure
+// Priority Queue structure (addressable: pos[] tracks where each process sits)
 typedef struct {
-    PCB            heap[HEAP_CAPACITY];   // the binary-heap array
+    int*           heap;                  // process indices in heap order
+    int*           keys;                  // priority of each heap entry
+    unsigned long* seqs;                  // per-element insertion sequence
+    int            capacity;              // allocated heap slots
+    int*           pos;                   // process index -> heap slot, -1 if absent
+    int            pos_capacity;          // entries allocated in pos[]
     int            size;                  // current number of elements
     unsigned long  seq_counter;           // next sequence number to assign
-    unsigned long  seqs[HEAP_CAPACITY];   // per-element insertion sequence
 } PCBMinPQ;
 
+// Ordered walk over a PCBMinPQ that leaves the heap untouched
+typedef struct {
+    const PCBMinPQ* pq;
+    int*            frontier; // candidate heap slots, kept as a min-heap
+    int             count;
+} MinPQIterator;
+
+// Min-heap of pending arrivals keyed on arrival time (ties broken by process index)
+typedef struct {
+    int* time;     // arrival time of each entry
+    int* index;    // index into processes[]
+    int  capacity;
+    int  size;
+} ArrivalQueue;
+
+// Red-black tree node; slot i + 1 belongs to process index i, slot 0 is the shared nil leaf
+typedef struct {
+    int           left, right, parent; // slots, 0 = nil
+    bool          red;
+    bool          linked;              // process is currently in the tree
+    long long     key;
+    unsigned long seq;                 // insertion order, breaks ties between equal keys
+} RunTreeNode;
+
+// Red-black tree of process indices ordered by key (CFS run queue)
+typedef struct {
+    RunTreeNode*  nodes;
+    int           capacity;    // allocated slots including nil
+    int           root;        // slot of the root, 0 when empty
+    int           leftmost;    // slot of the smallest entry, cached for O(1) peeks
+    int           size;
+    unsigned long seq_counter;
+} RunTree;
+
 // Struct for Memory
 typedef struct {
     char* name;
     char* value;
     int allocated;
+    bool dirty;     // Changed since the front end last refreshed
 } MemoryWord;
 
 // Struct for Resource
 typedef struct {
     char* name;
     int available;
-    PCB* holder_process;
+    int holder;          // index of the holding process, -1 when free
     PCBMinPQ* blocked;
-    int waiting_processes[MAX_PROCESSES];
-    int waiting_count;
 } Resource;
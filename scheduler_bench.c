@@ -0,0 +1,335 @@
+/**
+ * OS Scheduler Simulation - benchmarks
+ * Times the engine's building blocks (ready queues, mutex wait heaps, the CFS
+ * run tree, instruction execution, variable access) and whole simulations of
+ * generated workloads, and prints one CSV row per benchmark, e.g.
+ *   ./scheduler_bench > before.csv
+ *   ./scheduler_bench -b before.csv     # flags anything more than 10% slower
+ * Columns: benchmark,size,operations,seconds,ops_per_sec. For the simulate_*
+ * rows an operation is one simulated clock cycle.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "Engine.h"
+
+#define MAX_BASELINE 256
+#define MICRO_SIZE 100000 // elements per queue / heap / tree round, instructions per round
+
+static double min_seconds = 0.2;
+static char program_dir[] = "/tmp/scheduler_bench.XXXXXX";
+static char mutex_program[MAX_PATH_LENGTH];
+static char compute_program[MAX_PATH_LENGTH];
+
+// Results the benchmarks compute, stored so the compiler cannot drop the work
+static volatile long long bench_sink;
+
+// Results of an earlier run, for -b
+typedef struct {
+    char name[64];
+    int size;
+    double ops_per_sec;
+} BaselineEntry;
+
+static BaselineEntry baseline[MAX_BASELINE];
+static int baseline_count = 0;
+static double tolerance = 10;
+static int regressions = 0;
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [-n max] [-a alg,...] [-m seconds] [-b baseline.csv] [-t percent]\n"
+            "  -n  largest generated workload, in processes, 10 or more (default 100000)\n"
+            "  -a  algorithms to simulate: fcfs, rr, mlfq, cfs (default all)\n"
+            "  -m  minimum time spent on each benchmark (default 0.2)\n"
+            "  -b  compare with the CSV of an earlier run\n"
+            "  -t  slowdown against the baseline reported as a regression (default 10)\n",
+            prog);
+}
+
+static double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+// Same sequence on every run, so every run does the same work
+static unsigned next_random(unsigned* state) {
+    *state = *state * 1103515245u + 12345u;
+    return *state >> 16;
+}
+
+// Print one CSV row and check it against the baseline
+static void report(const char* name, int size, long long operations, double seconds) {
+    double rate = seconds > 0 ? operations / seconds : 0;
+    printf("%s,%d,%lld,%.6f,%.0f\n", name, size, operations, seconds, rate);
+    fflush(stdout);
+    for (int i = 0; i < baseline_count; i++) {
+        if (strcmp(baseline[i].name, name) != 0 || baseline[i].size != size)
+            continue;
+        if (rate < baseline[i].ops_per_sec * (1 - tolerance / 100)) {
+            fprintf(stderr, "Regression: %s (size %d) %.0f ops/s, baseline %.0f ops/s (%.1f%% slower)\n",
+                    name, size, rate, baseline[i].ops_per_sec,
+                    100 * (1 - rate / baseline[i].ops_per_sec));
+            regressions++;
+        }
+    }
+}
+
+static bool load_baseline(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+        return false;
+    char line[256];
+    while (fgets(line, sizeof(line), file) && baseline_count < MAX_BASELINE) {
+        BaselineEntry* entry = &baseline[baseline_count];
+        long long operations;
+        double seconds;
+        if (sscanf(line, "%63[^,],%d,%lld,%lf,%lf", entry->name, &entry->size,
+                   &operations, &seconds, &entry->ops_per_sec) == 5)
+            baseline_count++;
+    }
+    fclose(file);
+    return true;
+}
+
+// Repeat one round of a micro benchmark until min_seconds have passed
+static void run_micro(const char* name, long long (*round)(void)) {
+    long long operations = 0;
+    double start = now(), elapsed;
+    do {
+        operations += round();
+        elapsed = now() - start;
+    } while (elapsed < min_seconds);
+    report(name, MICRO_SIZE, operations, elapsed);
+}
+
+// -----------------------------------------------------------------------------
+// Micro benchmarks
+// -----------------------------------------------------------------------------
+
+static long long bench_queue(void) {
+    PCBQueue q;
+    int index;
+    initQueue(&q);
+    for (int i = 0; i < MICRO_SIZE; i++)
+        enqueuePCB(&q, i);
+    while (dequeuePCB(&q, &index))
+        ;
+    freeQueue(&q);
+    return 2LL * MICRO_SIZE;
+}
+
+static long long bench_min_pq(void) {
+    PCBMinPQ pq;
+    unsigned seed = 1;
+    int index;
+    initMinPQ(&pq);
+    for (int i = 0; i < MICRO_SIZE; i++)
+        minPQInsert(&pq, i, next_random(&seed) % 20);
+    while (minPQPop(&pq, &index))
+        ;
+    freeMinPQ(&pq);
+    return 2LL * MICRO_SIZE;
+}
+
+static long long bench_run_tree(void) {
+    RunTree tree;
+    unsigned seed = 1;
+    int index;
+    initRunTree(&tree);
+    for (int i = 0; i < MICRO_SIZE; i++)
+        runTreeInsert(&tree, i, next_random(&seed));
+    while (runTreePopMin(&tree, &index))
+        ;
+    freeRunTree(&tree);
+    return 2LL * MICRO_SIZE;
+}
+
+// The process the instruction and variable benchmarks run on
+static PCB* bench_process;
+
+static long long bench_instructions(void) {
+    PCB* p = bench_process;
+    for (int i = 0; i < MICRO_SIZE; i++)
+        executeInstruction(&p->code[i % p->instruction_count], p);
+    return MICRO_SIZE;
+}
+
+static long long bench_variables(void) {
+    static const char* values[] = { "0", "1", "17", "42", "255", "1000", "hello", "world" };
+    PCB* p = bench_process;
+    long long found = 0;
+    for (int i = 0; i < MICRO_SIZE; i++) {
+        setVariable(p, i % p->var_count, values[i % 8]);
+        found += getVariable(p, (i + 1) % p->var_count) != NULL;
+    }
+    bench_sink = found;
+    return 2LL * MICRO_SIZE;
+}
+
+// -----------------------------------------------------------------------------
+// End-to-end: generated workloads under each algorithm
+// -----------------------------------------------------------------------------
+
+static bool write_program(char* path, const char* name, const char* text) {
+    snprintf(path, MAX_PATH_LENGTH, "%s/%s", program_dir, name);
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+        return false;
+    fputs(text, file);
+    return fclose(file) == 0;
+}
+
+// Two program shapes: one contending for mutexes, one computing and reading input
+static bool write_programs(void) {
+    return mkdtemp(program_dir) != NULL &&
+           write_program(mutex_program, "mutex.txt",
+                         "semWait userOutput\nassign a 1\nassign b 3\nprint a\n"
+                         "semSignal userOutput\nsemWait file\nassign c 2\nsemSignal file\n") &&
+           write_program(compute_program, "compute.txt",
+                         "assign a 1\nassign b 20\nassign c a\nprintFromTo a b\n"
+                         "assign d input\nprint d\n");
+}
+
+static void remove_programs(void) {
+    unlink(mutex_program);
+    unlink(compute_program);
+    rmdir(program_dir);
+}
+
+// Fresh instance holding `processes` generated processes, two arriving per cycle
+static Simulation* build_workload(SchedulingAlgorithm algorithm, int processes) {
+    Simulation* instance = engineCreate();
+    if (instance == NULL)
+        return NULL;
+    engineSelect(instance);
+    engineSetInputGenerator(1, 0, 100);
+    engineSetOutputRing(0);
+    sim->current_algorithm = algorithm;
+    for (int i = 0; i < processes; i++) {
+        if (engineAddProcess(i % 3 == 0 ? mutex_program : compute_program, i / 2, i % 5) < 0) {
+            engineDestroy(instance);
+            return NULL;
+        }
+    }
+    return instance;
+}
+
+// Simulated cycles per second; small workloads are run repeatedly
+static bool run_simulation(SchedulingAlgorithm algorithm, const char* name, int processes) {
+    long long cycles = 0;
+    double elapsed = 0;
+    do {
+        Simulation* instance = build_workload(algorithm, processes);
+        if (instance == NULL)
+            return false;
+        double start = now();
+        engineRun();
+        elapsed += now() - start;
+        cycles += sim->clock_cycle;
+        engineDestroy(instance);
+    } while (elapsed < min_seconds);
+    engineSelect(NULL);
+    report(name, processes, cycles, elapsed);
+    return true;
+}
+
+// Parse "fcfs,rr,..." into algorithms[]; returns the number of names or -1
+static int parse_algorithms(const char* text, SchedulingAlgorithm* algorithms) {
+    static const char* names[] = { "fcfs", "rr", "mlfq", "cfs" };
+    static const SchedulingAlgorithm values[] = { FCFS, ROUND_ROBIN, MULTILEVEL_FEEDBACK, CFS };
+    int count = 0;
+    while (*text) {
+        size_t len = strcspn(text, ",");
+        int found = -1;
+        for (int i = 0; i < 4; i++) {
+            if (strlen(names[i]) == len && strncmp(text, names[i], len) == 0)
+                found = i;
+        }
+        if (found < 0 || count == 4)
+            return -1;
+        algorithms[count++] = values[found];
+        text += len;
+        if (*text == ',')
+            text++;
+    }
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    SchedulingAlgorithm algorithms[4] = { FCFS, ROUND_ROBIN, MULTILEVEL_FEEDBACK, CFS };
+    int algorithm_count = 4;
+    int max_processes = 100000;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:a:m:b:t:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                max_processes = atoi(optarg);
+                if (max_processes < 10) { usage(argv[0]); return 1; }
+                break;
+            case 'a':
+                algorithm_count = parse_algorithms(optarg, algorithms);
+                if (algorithm_count < 1) { usage(argv[0]); return 1; }
+                break;
+            case 'm':
+                min_seconds = atof(optarg);
+                if (min_seconds < 0) { usage(argv[0]); return 1; }
+                break;
+            case 'b':
+                if (!load_baseline(optarg)) {
+                    fprintf(stderr, "Could not read %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 't':
+                tolerance = atof(optarg);
+                if (tolerance < 0) { usage(argv[0]); return 1; }
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (!write_programs()) {
+        fprintf(stderr, "Could not write the benchmark programs\n");
+        return 1;
+    }
+
+    printf("benchmark,size,operations,seconds,ops_per_sec\n");
+    run_micro("queue_enqueue_dequeue", bench_queue);
+    run_micro("minpq_insert_pop", bench_min_pq);
+    run_micro("runtree_insert_popmin", bench_run_tree);
+
+    // Instruction and variable benchmarks run on one loaded process
+    engineInit();
+    engineSetInputGenerator(1, 0, 100);
+    engineSetOutputRing(0);
+    if (engineAddProcess(compute_program, 0, 0) < 0) {
+        fprintf(stderr, "Could not load the benchmark program\n");
+        remove_programs();
+        return 1;
+    }
+    bench_process = &sim->processes[0];
+    run_micro("execute_instruction", bench_instructions);
+    run_micro("set_get_variable", bench_variables);
+
+    for (int a = 0; a < algorithm_count; a++) {
+        char name[64];
+        snprintf(name, sizeof(name), "simulate_%s",
+                 algorithms[a] == FCFS ? "fcfs" : algorithms[a] == ROUND_ROBIN ? "rr" :
+                 algorithms[a] == MULTILEVEL_FEEDBACK ? "mlfq" : "cfs");
+        for (int n = 10; n <= max_processes; n *= 10) {
+            if (!run_simulation(algorithms[a], name, n)) {
+                fprintf(stderr, "Could not build a workload of %d processes\n", n);
+                remove_programs();
+                return 1;
+            }
+        }
+    }
+    remove_programs();
+    return regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,287 @@
+/**
+ * OS Scheduler Simulation - command line batch runner
+ * Runs the headless engine without a display, e.g.
+ *   ./scheduler_cli -a rr -q 2 Program_1.txt:0 Program_2.txt:1 Program_3.txt:4
+ * Values for "assign x input" are read from stdin, one per line, unless -i
+ * names a values file or -g generates them. Program output goes to stdout
+ * unless -o names a file. Programs read the files loaded with -F; files they
+ * write reach the file system when the run finishes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Engine.h"
+
+static bool quiet = false;
+
+static void cli_log(const char* message) {
+    if (!quiet)
+        printf("[%d] %s\n", sim->clock_cycle, message);
+}
+
+// Only used on a terminal; piped stdin is an input stream (engineSetInputStream)
+static bool cli_read_input(PCB* process, const char* variable, char* out, int out_size) {
+    fprintf(stderr, "Process %d: value for %s? ", process->process_id, variable);
+    if (!fgets(out, out_size, stdin))
+        return false;
+    out[strcspn(out, "\r\n")] = '\0';
+    return true;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [-a fcfs|rr|mlfq|cfs] [-q quantum] [-L levels] [-Q q1,q2,...] [-B cycles]\n"
+            "       [-c cores] [-n max] [-t trace] [-m metrics.csv] [-i values | -g seed[:min:max]]\n"
+            "       [-o output] [-F file]... [-D latency[:depth]] [-S fcfs|sstf|scan|clook]\n"
+            "       [-f] [-s] program[:arrival[:priority]]...\n"
+            "       %s -R trace [-m metrics.csv] [-s]\n"
+            "  -a  scheduling algorithm (default fcfs)\n"
+            "  -q  Round Robin quantum (default 2)\n"
+            "  -L  MLFQ levels, 1-%d (default %d)\n"
+            "  -Q  MLFQ quantum per level, comma separated (default 1,2,4,...)\n"
+            "  -B  MLFQ priority boost every N cycles (default off)\n"
+            "  -c  simulated cores, 1-%d (default 1)\n"
+            "  -n  upper bound on the number of processes (default %d)\n"
+            "  -t  record a binary execution trace to this file\n"
+            "  -R  replay a recorded trace instead of running programs\n"
+            "  -m  write per-process metrics as CSV to this file\n"
+            "  -i  values for \"assign x input\" from this file, one per line;\n"
+            "      \"3: value\" lines are used by process 3 before the shared ones\n"
+            "  -g  generate input values from a seed (default range 0:100)\n"
+            "  -o  write program output to this file instead of stdout\n"
+            "  -F  load a file for readFile before the run (repeatable)\n"
+            "  -D  file instructions block for this many cycles on a disk serving\n"
+            "      up to depth requests at once (default 0, instant; depth %d)\n"
+            "  -S  disk scheduling: order waiting requests get the head (default fcfs)\n"
+            "  -f  fast-forward idle cycles to the next arrival\n"
+            "  -s  silent, only print the summary\n",
+            prog, prog, MLFQ_MAX_LEVELS, MLFQ_DEFAULT_LEVELS, MAX_CPUS, DEFAULT_PROCESS_LIMIT,
+            DISK_DEFAULT_DEPTH);
+}
+
+// Parse "q1,q2,..." into quanta[]; returns the number of values or -1
+static int parse_quanta(const char* text, int* quanta) {
+    int count = 0;
+    while (*text) {
+        char* end;
+        long value = strtol(text, &end, 10);
+        if (end == text || value < 1 || count == MLFQ_MAX_LEVELS)
+            return -1;
+        quanta[count++] = (int)value;
+        text = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',')
+            return -1;
+    }
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    int opt;
+    int levels = MLFQ_DEFAULT_LEVELS;
+    int quanta[MLFQ_MAX_LEVELS];
+    int quanta_count = 0;
+    const char* trace_path = NULL;
+    const char* replay_path = NULL;
+    const char* metrics_path = NULL;
+    const char* input_path = NULL;
+    const char* generator = NULL;
+    const char* output_path = NULL;
+    int disk_latency = 0, disk_depth = DISK_DEFAULT_DEPTH;
+    while ((opt = getopt(argc, argv, "a:q:L:Q:B:c:n:t:R:m:i:g:o:F:D:S:fsh")) != -1) {
+        switch (opt) {
+            case 'a':
+                if (strcmp(optarg, "fcfs") == 0) sim->current_algorithm = FCFS;
+                else if (strcmp(optarg, "rr") == 0) sim->current_algorithm = ROUND_ROBIN;
+                else if (strcmp(optarg, "mlfq") == 0) sim->current_algorithm = MULTILEVEL_FEEDBACK;
+                else if (strcmp(optarg, "cfs") == 0) sim->current_algorithm = CFS;
+                else { usage(argv[0]); return 1; }
+                break;
+            case 'q':
+                sim->quantum = atoi(optarg);
+                if (sim->quantum < 1) { usage(argv[0]); return 1; }
+                break;
+            case 'L':
+                levels = atoi(optarg);
+                if (levels < 1 || levels > MLFQ_MAX_LEVELS) { usage(argv[0]); return 1; }
+                break;
+            case 'Q':
+                quanta_count = parse_quanta(optarg, quanta);
+                if (quanta_count < 1) { usage(argv[0]); return 1; }
+                break;
+            case 'B':
+                sim->mlfq_boost_interval = atoi(optarg);
+                if (sim->mlfq_boost_interval < 0) { usage(argv[0]); return 1; }
+                break;
+            case 'c':
+                if (!engineSetCpuCount(atoi(optarg))) { usage(argv[0]); return 1; }
+                break;
+            case 'n':
+                process_limit = atoi(optarg);
+                if (process_limit < 1) { usage(argv[0]); return 1; }
+                break;
+            case 't':
+                trace_path = optarg;
+                break;
+            case 'R':
+                replay_path = optarg;
+                break;
+            case 'm':
+                metrics_path = optarg;
+                break;
+            case 'i':
+                input_path = optarg;
+                break;
+            case 'g':
+                generator = optarg;
+                break;
+            case 'o':
+                output_path = optarg;
+                break;
+            case 'F':
+                if (!engineLoadFile(optarg)) {
+                    fprintf(stderr, "Could not read %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'D':
+                if (sscanf(optarg, "%d:%d", &disk_latency, &disk_depth) < 1 ||
+                    !engineSetDisk(disk_latency, disk_depth)) { usage(argv[0]); return 1; }
+                break;
+            case 'S':
+                if (strcmp(optarg, "fcfs") == 0) engineSetDiskPolicy(DISK_FCFS);
+                else if (strcmp(optarg, "sstf") == 0) engineSetDiskPolicy(DISK_SSTF);
+                else if (strcmp(optarg, "scan") == 0) engineSetDiskPolicy(DISK_SCAN);
+                else if (strcmp(optarg, "clook") == 0) engineSetDiskPolicy(DISK_CLOOK);
+                else { usage(argv[0]); return 1; }
+                break;
+            case 'f':
+                sim->fast_forward_idle = true;
+                break;
+            case 's':
+                quiet = true;
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind >= argc && replay_path == NULL) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // -Q sets the level count too unless -L was given; missing quanta repeat the last one
+    if (quanta_count > 0) {
+        for (int l = quanta_count; l < MLFQ_MAX_LEVELS; l++)
+            quanta[l] = quanta[quanta_count - 1];
+        if (levels == MLFQ_DEFAULT_LEVELS && quanta_count != MLFQ_DEFAULT_LEVELS)
+            levels = quanta_count;
+    }
+    mlfqConfigure(levels, quanta_count > 0 ? quanta : NULL);
+
+    EngineClient client = {
+        .log = cli_log,
+        .read_input = cli_read_input,
+        .show_output = NULL,
+        .on_update = NULL
+    };
+    engineSetClient(&client);
+    engineInit();
+
+    // Input: -i file, -g generator, else stdin (asking for each value on a terminal)
+    if (input_path && !engineSetInputFile(input_path)) {
+        fprintf(stderr, "Could not read %s\n", input_path);
+        return 1;
+    }
+    if (generator) {
+        unsigned seed = 0;
+        int min = 0, max = 100;
+        if (sscanf(generator, "%u:%d:%d", &seed, &min, &max) < 1) {
+            usage(argv[0]);
+            return 1;
+        }
+        engineSetInputGenerator(seed, min, max);
+    }
+    if (!input_path && !generator && !isatty(STDIN_FILENO))
+        engineSetInputStream(stdin);
+
+    // Program output shares stdout with the log, so the two stay in order
+    if (output_path && !engineSetOutputFile(output_path)) {
+        fprintf(stderr, "Could not create %s\n", output_path);
+        return 1;
+    }
+    if (!output_path)
+        engineSetOutputStream(stdout);
+
+    // The trace carries the programs and settings, so a replay needs nothing else
+    if (replay_path && !engineStartReplay(replay_path)) {
+        fprintf(stderr, "Could not read trace %s\n", replay_path);
+        return 1;
+    }
+    if (trace_path && !engineStartTrace(trace_path)) {
+        fprintf(stderr, "Could not create trace %s\n", trace_path);
+        return 1;
+    }
+
+    // program[:arrival[:priority]]
+    for (int i = replay_path ? argc : optind; i < argc; i++) {
+        char path[MAX_PATH_LENGTH];
+        int arrival_time = 0, priority = 0;
+        snprintf(path, sizeof(path), "%s", argv[i]);
+        char* sep = strchr(path, ':');
+        if (sep) {
+            *sep = '\0';
+            sscanf(sep + 1, "%d:%d", &arrival_time, &priority);
+        }
+        if (engineAddProcess(path, arrival_time, priority) < 0) {
+            fprintf(stderr, "Could not load %s\n", path);
+            return 1;
+        }
+    }
+
+    engineRun();
+    if (trace_path && !engineStopTrace())
+        fprintf(stderr, "Could not write trace %s\n", trace_path);
+    if (!engineFlushOutput())
+        fprintf(stderr, "Could not write program output\n");
+    if (!replay_path && !engineSyncFiles())
+        fprintf(stderr, "Could not write every file the programs wrote\n");
+    if (metrics_path && !engineWriteMetrics(metrics_path))
+        fprintf(stderr, "Could not write metrics %s\n", metrics_path);
+
+    printf("Algorithm: %s\n", engineAlgorithmName(sim->current_algorithm));
+    printf("Processes: %d\n", sim->process_count);
+    printf("Clock cycles: %d\n", sim->clock_cycle);
+    printf("Idle cycles: %d\n", sim->idleCount);
+    printf("Fairness (Jain index over slowdown): %.3f\n", engineFairnessIndex());
+    printf("Max slowdown: %.2f\n", engineMaxSlowdown());
+    printf("%-10s %10s %8s %8s %8s %8s\n", "Metric", "Mean", "p50", "p95", "p99", "Max");
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        const Histogram* h = engineMetric(m);
+        printf("%-10s %10.2f %8d %8d %8d %8d\n", engineMetricName(m), histogramMean(h),
+               histogramPercentile(h, 50), histogramPercentile(h, 95),
+               histogramPercentile(h, 99), h->max);
+    }
+    // Per disk request: submission to completion, queueing and seeks included
+    if (sim->disk.completed > 0) {
+        const Histogram* h = &sim->disk.latency;
+        printf("%-10s %10.2f %8d %8d %8d %8d\n", "Disk req", histogramMean(h),
+               histogramPercentile(h, 50), histogramPercentile(h, 95),
+               histogramPercentile(h, 99), h->max);
+    }
+    if (sim->cpu_count > 1) {
+        for (int c = 0; c < sim->cpu_count; c++)
+            printf("Core %d: utilization %.1f%%, %d migrations\n",
+                   c, engineCoreUtilization(c) * 100, sim->cores[c].migrations);
+    }
+    if (sim->disk.completed > 0) {
+        printf("Disk (%s): %lld requests, utilization %.1f%%, %.1f%% overlapped with CPU work\n",
+               diskPolicyName(sim->disk_policy), sim->disk.completed,
+               engineDiskUtilization() * 100, engineIoOverlap() * 100);
+        printf("Seek distance: %lld blocks, %.2f per request\n", sim->disk.seek_distance,
+               (double)sim->disk.seek_distance / sim->disk.completed);
+    }
+    return 0;
+}
@@ -0,0 +1,364 @@
+/**
+ * OS Scheduler Simulation - parallel parameter sweep
+ * Runs one workload under every combination of algorithm, Round Robin
+ * quantum and MLFQ level count, each as its own engine instance on a pool
+ * of worker threads, and prints one comparative table, e.g.
+ *   ./scheduler_sweep -a rr,mlfq -q 1,2,4 -L 2,3,4 -i inputs.txt Program_1.txt:0 Program_2.txt:1
+ * Values for "assign x input" come from the -i values file or the -g
+ * generator, seed 0 when neither is given; every run gets the same values. Every run also starts from the
+ * same copy of the -F files, loaded once, and never writes files back.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "Engine.h"
+
+#define MAX_SWEEP_VALUES 64
+
+// One program of the workload: file[:arrival[:priority]]
+typedef struct {
+    char path[MAX_PATH_LENGTH];
+    int arrival_time;
+    int priority;
+} WorkloadEntry;
+
+// One point of the grid and what it measured
+typedef struct {
+    SchedulingAlgorithm algorithm;
+    int quantum;            // Round Robin only
+    int levels;             // MLFQ only
+    bool failed;
+    int cycles;
+    double turnaround;      // mean finish - arrival
+    double response;        // mean first dispatch - arrival
+    double waiting;         // mean turnaround - instructions executed
+    int p95_turnaround;
+    int max_turnaround;
+    double fairness;
+} SweepJob;
+
+static WorkloadEntry* workload = NULL;
+static int workload_count = 0;
+static const char* input_path = NULL;
+static const char* generator = NULL;
+static int cpu_count = 1;
+static int boost_interval = 0;
+static int disk_latency = 0;
+static int disk_depth = DISK_DEFAULT_DEPTH;
+static DiskPolicy disk_policy = DISK_FCFS;
+static const FileSet* files = NULL;     // -F files, loaded before the workers start
+
+static SweepJob* jobs = NULL;
+static int job_count = 0;
+static int next_job = 0;
+static pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [-a alg,...] [-q q1,q2,...] [-L l1,l2,...] [-B cycles] [-c cores]\n"
+            "       [-D latency[:depth]] [-S fcfs|sstf|scan|clook] [-j threads]\n"
+            "       [-F file]... [-i values | -g seed[:min:max]]\n"
+            "       program[:arrival[:priority]]...\n"
+            "  -a  algorithms to compare: fcfs, rr, mlfq, cfs (default all)\n"
+            "  -q  Round Robin quanta to try (default 2)\n"
+            "  -L  MLFQ level counts to try, 1-%d (default %d)\n"
+            "  -B  MLFQ priority boost every N cycles (default off)\n"
+            "  -c  simulated cores per run, 1-%d (default 1)\n"
+            "  -D  disk latency of file instructions and requests served at once\n"
+            "      (default 0, instant)\n"
+            "  -S  disk scheduling policy (default fcfs)\n"
+            "  -j  worker threads (default: online host CPUs)\n"
+            "  -i  file with values for \"assign x input\", one per line;\n"
+            "      \"3: value\" lines are used by process 3 before the shared ones\n"
+            "  -g  generate input values from a seed (default range 0:100);\n"
+            "      without -i or -g, values are generated from seed 0\n"
+            "  -F  load a file for readFile; every run starts from the same copy\n",
+            prog, MLFQ_MAX_LEVELS, MLFQ_DEFAULT_LEVELS, MAX_CPUS);
+}
+
+// Parse "v1,v2,..." into values[]; returns the number of values or -1
+static int parse_list(const char* text, int* values, int min, int max) {
+    int count = 0;
+    while (*text) {
+        char* end;
+        long value = strtol(text, &end, 10);
+        if (end == text || value < min || value > max || count == MAX_SWEEP_VALUES)
+            return -1;
+        values[count++] = (int)value;
+        if (*end && *end != ',')
+            return -1;
+        text = *end == ',' ? end + 1 : end;
+    }
+    return count;
+}
+
+// Parse "fcfs,rr,..." into algorithms[]; returns the number of names or -1
+static int parse_algorithms(const char* text, SchedulingAlgorithm* algorithms) {
+    static const struct { const char* name; SchedulingAlgorithm algorithm; } names[] = {
+        { "fcfs", FCFS }, { "rr", ROUND_ROBIN }, { "mlfq", MULTILEVEL_FEEDBACK }, { "cfs", CFS }
+    };
+    int count = 0;
+    while (*text) {
+        size_t len = strcspn(text, ",");
+        int found = -1;
+        for (int i = 0; i < 4; i++) {
+            if (strlen(names[i].name) == len && strncmp(text, names[i].name, len) == 0)
+                found = i;
+        }
+        if (found < 0 || count == MAX_SWEEP_VALUES)
+            return -1;
+        algorithms[count++] = names[found].algorithm;
+        text += len;
+        if (*text == ',')
+            text++;
+    }
+    return count;
+}
+
+// Input source for the instance of the calling thread, from -i or -g; runs
+// have no stdin to share, so without either the generator starts at seed 0
+static bool select_inputs(void) {
+    unsigned seed = 0;
+    int min = 0, max = 100;
+    if (input_path)
+        return engineSetInputFile(input_path);
+    if (generator && sscanf(generator, "%u:%d:%d", &seed, &min, &max) < 1)
+        return false;
+    engineSetInputGenerator(seed, min, max);
+    return true;
+}
+
+static void add_job(SchedulingAlgorithm algorithm, int quantum, int levels) {
+    SweepJob* job = &jobs[job_count++];
+    memset(job, 0, sizeof(*job));
+    job->algorithm = algorithm;
+    job->quantum = quantum;
+    job->levels = levels;
+}
+
+// Run one grid point start to finish in a private engine instance
+static void run_job(SweepJob* job) {
+    Simulation* instance = engineCreate();
+    if (instance == NULL) {
+        job->failed = true;
+        return;
+    }
+    engineSelect(instance);
+
+    sim->current_algorithm = job->algorithm;
+    sim->quantum = job->quantum;
+    sim->mlfq_boost_interval = boost_interval;
+    mlfqConfigure(job->levels, NULL);
+    engineSetCpuCount(cpu_count);
+    engineSetDisk(disk_latency, disk_depth);
+    engineSetDiskPolicy(disk_policy);
+    engineUseFiles(files);
+    if (!select_inputs()) {
+        job->failed = true;
+        engineDestroy(instance);
+        return;
+    }
+
+    for (int i = 0; i < workload_count; i++) {
+        if (engineAddProcess(workload[i].path, workload[i].arrival_time,
+                             workload[i].priority) < 0) {
+            job->failed = true;
+            engineDestroy(instance);
+            return;
+        }
+    }
+    engineRun();
+
+    job->cycles = sim->clock_cycle;
+    job->turnaround = histogramMean(engineMetric(METRIC_TURNAROUND));
+    job->response = histogramMean(engineMetric(METRIC_RESPONSE));
+    job->waiting = histogramMean(engineMetric(METRIC_WAITING));
+    job->p95_turnaround = histogramPercentile(engineMetric(METRIC_TURNAROUND), 95);
+    job->max_turnaround = engineMetric(METRIC_TURNAROUND)->max;
+    job->fairness = engineFairnessIndex();
+    engineDestroy(instance);
+}
+
+static void* sweep_worker(void* arg) {
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&job_lock);
+        int j = next_job++;
+        pthread_mutex_unlock(&job_lock);
+        if (j >= job_count)
+            return NULL;
+        run_job(&jobs[j]);
+    }
+}
+
+static void print_table(void) {
+    printf("%-27s %7s %6s %8s %10s %9s %9s %8s %8s %8s\n", "Algorithm", "Quantum", "Levels",
+           "Cycles", "Turnaround", "Response", "Waiting", "P95Turn", "MaxTurn", "Fairness");
+    for (int j = 0; j < job_count; j++) {
+        SweepJob* job = &jobs[j];
+        char quantum_text[16] = "-", levels_text[16] = "-";
+        if (job->algorithm == ROUND_ROBIN)
+            sprintf(quantum_text, "%d", job->quantum);
+        if (job->algorithm == MULTILEVEL_FEEDBACK)
+            sprintf(levels_text, "%d", job->levels);
+        printf("%-27s %7s %6s ", engineAlgorithmName(job->algorithm), quantum_text, levels_text);
+        if (job->failed)
+            printf("%8s\n", "failed");
+        else
+            printf("%8d %10.2f %9.2f %9.2f %8d %8d %8.3f\n", job->cycles, job->turnaround,
+                   job->response, job->waiting, job->p95_turnaround, job->max_turnaround,
+                   job->fairness);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    SchedulingAlgorithm algorithms[MAX_SWEEP_VALUES] = { FCFS, ROUND_ROBIN, MULTILEVEL_FEEDBACK, CFS };
+    int algorithm_count = 4;
+    int quanta[MAX_SWEEP_VALUES] = { 2 };
+    int quantum_count = 1;
+    int levels[MAX_SWEEP_VALUES] = { MLFQ_DEFAULT_LEVELS };
+    int level_count = 1;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:q:L:B:c:D:S:j:i:g:F:h")) != -1) {
+        switch (opt) {
+            case 'a':
+                algorithm_count = parse_algorithms(optarg, algorithms);
+                if (algorithm_count < 1) { usage(argv[0]); return 1; }
+                break;
+            case 'q':
+                quantum_count = parse_list(optarg, quanta, 1, MLFQ_MAX_QUANTUM);
+                if (quantum_count < 1) { usage(argv[0]); return 1; }
+                break;
+            case 'L':
+                level_count = parse_list(optarg, levels, 1, MLFQ_MAX_LEVELS);
+                if (level_count < 1) { usage(argv[0]); return 1; }
+                break;
+            case 'B':
+                boost_interval = atoi(optarg);
+                if (boost_interval < 0) { usage(argv[0]); return 1; }
+                break;
+            case 'c':
+                cpu_count = atoi(optarg);
+                if (cpu_count < 1 || cpu_count > MAX_CPUS) { usage(argv[0]); return 1; }
+                break;
+            case 'D':
+                if (sscanf(optarg, "%d:%d", &disk_latency, &disk_depth) < 1 ||
+                    disk_latency < 0 || disk_depth < 1) { usage(argv[0]); return 1; }
+                break;
+            case 'S':
+                if (strcmp(optarg, "fcfs") == 0) disk_policy = DISK_FCFS;
+                else if (strcmp(optarg, "sstf") == 0) disk_policy = DISK_SSTF;
+                else if (strcmp(optarg, "scan") == 0) disk_policy = DISK_SCAN;
+                else if (strcmp(optarg, "clook") == 0) disk_policy = DISK_CLOOK;
+                else { usage(argv[0]); return 1; }
+                break;
+            case 'j':
+                threads = atol(optarg);
+                if (threads < 1) { usage(argv[0]); return 1; }
+                break;
+            case 'i':
+                input_path = optarg;
+                break;
+            case 'g':
+                generator = optarg;
+                break;
+            case 'F':
+                if (!engineLoadFile(optarg)) {
+                    fprintf(stderr, "Could not read %s\n", optarg);
+                    return 1;
+                }
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (threads < 1)
+        threads = 1;
+
+    // Check -i and -g once on this thread's instance before any worker starts
+    if (!select_inputs()) {
+        if (input_path)
+            fprintf(stderr, "Could not read %s\n", input_path);
+        else
+            usage(argv[0]);
+        return 1;
+    }
+    engineUseInputClient();
+    files = engineLoadedFiles();
+
+    // program[:arrival[:priority]]
+    workload_count = argc - optind;
+    workload = calloc(workload_count, sizeof(WorkloadEntry));
+    if (workload == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < workload_count; i++) {
+        WorkloadEntry* entry = &workload[i];
+        snprintf(entry->path, sizeof(entry->path), "%s", argv[optind + i]);
+        char* sep = strchr(entry->path, ':');
+        if (sep) {
+            *sep = '\0';
+            sscanf(sep + 1, "%d:%d", &entry->arrival_time, &entry->priority);
+        }
+    }
+
+    // Only the parameters an algorithm uses are swept for it
+    jobs = calloc((size_t)algorithm_count * MAX_SWEEP_VALUES, sizeof(SweepJob));
+    if (jobs == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (int a = 0; a < algorithm_count; a++) {
+        if (algorithms[a] == ROUND_ROBIN) {
+            for (int q = 0; q < quantum_count; q++)
+                add_job(algorithms[a], quanta[q], MLFQ_DEFAULT_LEVELS);
+        } else if (algorithms[a] == MULTILEVEL_FEEDBACK) {
+            for (int l = 0; l < level_count; l++)
+                add_job(algorithms[a], quanta[0], levels[l]);
+        } else {
+            add_job(algorithms[a], quanta[0], MLFQ_DEFAULT_LEVELS);
+        }
+    }
+    if (threads > job_count)
+        threads = job_count;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    if (workers == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        if (pthread_create(&workers[t], NULL, sweep_worker, NULL) != 0)
+            break;
+        started++;
+    }
+    if (started == 0)
+        sweep_worker(NULL);
+    for (int t = 0; t < started; t++)
+        pthread_join(workers[t], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    print_table();
+    fprintf(stderr, "%d runs on %d threads in %.3f s\n", job_count, started > 0 ? started : 1,
+            (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+
+    free(workers);
+    free(jobs);
+    free(workload);
+    return 0;
+}